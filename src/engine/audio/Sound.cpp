@@ -1,94 +1,97 @@
 #include "Sound.h"
 #include <iostream>
 #include "../utils/Log.h"
+#include "../core/AssetCache.h"
+#include "SoundManager.h"
 
-Sound::Sound() : sound(nullptr), isLoaded(false), playing(false), looping(false), volume(1.0f), channel(-1) {
+Sound::Sound() : sound(nullptr), loaded(false), looping(false), volume(1.0f), duration(0.0f),
+                 playback(std::make_shared<Playback>()) {
 }
 
 Sound::~Sound() {
-    if (isLoaded) {
-        Mix_FreeChunk(sound);
+    if (loaded) {
+        // Queued behind any playback calls that still use the chunk.
+        Mix_Chunk* chunk = sound;
+        SoundManager::post([chunk] { Mix_FreeChunk(chunk); });
     }
 }
 
 bool Sound::load(const std::string& path) {
-    sound = Mix_LoadWAV(path.c_str());
+    sound = AssetCache::getInstance().takeChunk(path);
+    if (!sound) {
+        sound = SoundManager::loadChunk(path);
+    }
     if (!sound) {
         Log::getInstance().error("Failed to load sound: " + std::string(Mix_GetError()));
         return false;
     }
 
-    isLoaded = true;
+    duration = SoundManager::getDuration(sound);
+    loaded = true;
     return true;
 }
 
 void Sound::play() {
-    if (!isLoaded) return;
-    
-    int loops = looping ? -1 : 0;
-    channel = Mix_PlayChannel(-1, sound, loops);
-    if (channel == -1) {
-        Log::getInstance().error("Failed to play sound: " + std::string(Mix_GetError()));
-        return;
-    }
-    
-    Mix_Volume(channel, static_cast<int>(volume * MIX_MAX_VOLUME));
-    playing = true;
+    if (!loaded) return;
+
+    SoundManager::post([chunk = sound, state = playback, loops = looping ? -1 : 0, volume = volume] {
+        state->channel = Mix_PlayChannel(-1, chunk, loops);
+        if (state->channel == -1) {
+            Log::getInstance().error("Failed to play sound: " + std::string(Mix_GetError()));
+            return;
+        }
+        Mix_Volume(state->channel, static_cast<int>(volume * MIX_MAX_VOLUME));
+        state->playing = true;
+    });
 }
 
 void Sound::pause() {
-    if (!isLoaded || channel == -1) return;
-    Mix_Pause(channel);
-    playing = false;
+    if (!loaded) return;
+    SoundManager::post([state = playback] {
+        if (state->channel == -1) return;
+        Mix_Pause(state->channel);
+        state->playing = false;
+    });
 }
 
 void Sound::resume() {
-    if (!isLoaded || channel == -1) return;
-    Mix_Resume(channel);
-    playing = true;
+    if (!loaded) return;
+    SoundManager::post([state = playback] {
+        if (state->channel == -1) return;
+        Mix_Resume(state->channel);
+        state->playing = true;
+    });
 }
 
 void Sound::stop() {
-    if (!isLoaded || channel == -1) return;
-    Mix_HaltChannel(channel);
-    playing = false;
-    channel = -1;
+    if (!loaded) return;
+    SoundManager::post([state = playback] {
+        if (state->channel == -1) return;
+        Mix_HaltChannel(state->channel);
+        state->playing = false;
+        state->channel = -1;
+    });
 }
 
 void Sound::setVolume(float vol) {
     volume = vol;
-    if (isLoaded && channel != -1) {
-        Mix_Volume(channel, static_cast<int>(volume * MIX_MAX_VOLUME));
-    }
+    if (!loaded) return;
+    SoundManager::post([state = playback, vol] {
+        if (state->channel == -1) return;
+        Mix_Volume(state->channel, static_cast<int>(vol * MIX_MAX_VOLUME));
+    });
 }
 
 void Sound::setLoop(bool loop) {
     looping = loop;
-    if (isLoaded && playing && channel != -1) {
-        int loops = looping ? -1 : 0;
-        Mix_PlayChannel(channel, sound, loops);
-    }
+    if (!loaded) return;
+    SoundManager::post([chunk = sound, state = playback, loops = loop ? -1 : 0] {
+        if (state->playing && state->channel != -1) {
+            Mix_PlayChannel(state->channel, chunk, loops);
+        }
+    });
 }
 
 bool Sound::isPlaying() const {
-    if (!isLoaded || channel == -1) return false;
-    return Mix_Playing(channel) && !Mix_Paused(channel);
-}
-
-float Sound::getDuration() const {
-    if (!isLoaded || !sound) return 0.0f;
-    
-    int frequency;
-    Uint16 format;
-    int channels;
-    Mix_QuerySpec(&frequency, &format, &channels);
-    
-    int bytesPerSample = 2;
-    if (format == AUDIO_U8 || format == AUDIO_S8) {
-        bytesPerSample = 1;
-    }
-    
-    Uint32 points = sound->alen / (bytesPerSample * channels);
-    float duration = static_cast<float>(points) / static_cast<float>(frequency);
-    return duration;
+    return loaded && playback->playing;
 }
@@ -1,7 +1,12 @@
 #pragma once
+#include <atomic>
+#include <memory>
 #include <string>
 #include <SDL2/SDL_mixer.h>
 
+// Playback calls are queued to the main thread (see SoundManager::post), so a
+// Sound can be driven from the simulation thread. They may run after the Sound
+// is gone, so the channel state they share is held separately.
 class Sound {
 public:
     Sound();
@@ -14,14 +19,23 @@ public:
     void stop();
     void setVolume(float volume);
     void setLoop(bool loop);
+    // Whether the last queued play or resume has started and not been paused
+    // or stopped since. Doesn't notice a one-shot sound running out.
     bool isPlaying() const;
-    float getDuration() const;
+    bool isLoaded() const { return loaded; }
+    float getDuration() const { return duration; }
+    const Mix_Chunk* getChunk() const { return sound; }
 
 private:
+    struct Playback {
+        int channel = -1;
+        std::atomic<bool> playing{false};
+    };
+
     Mix_Chunk* sound;
-    bool isLoaded;
-    bool playing;
+    bool loaded;
     bool looping;
     float volume;
-    int channel;
-}; 
\ No newline at end of file
+    float duration;
+    std::shared_ptr<Playback> playback;
+};
@@ -1,8 +1,14 @@
 #include "SoundManager.h"
 #include <iostream>
 #include "../utils/Log.h"
+#include "../core/Engine.h"
+#include <mutex>
 
-SoundManager::SoundManager() : currentMusic(nullptr) {}
+namespace {
+    std::mutex loadMutex;
+}
+
+SoundManager::SoundManager() : currentMusic(nullptr), musicPlaying(false) {}
 
 SoundManager::~SoundManager() {
     for (auto& pair : sounds) {
@@ -18,60 +24,102 @@ SoundManager& SoundManager::getInstance() {
     return instance;
 }
 
-void SoundManager::playMusic(const std::string& path, float volume) {
-    if (currentMusic) {
-        Mix_FreeMusic(currentMusic);
-    }
+Mix_Chunk* SoundManager::loadChunk(const std::string& path) {
+    std::lock_guard<std::mutex> lock(loadMutex);
+    return Mix_LoadWAV(path.c_str());
+}
 
-    currentMusic = Mix_LoadMUS(path.c_str());
-    if (!currentMusic) {
-        Log::getInstance().error("Failed to load music: " + std::string(Mix_GetError()));
-        return;
-    }
+Mix_Music* SoundManager::loadMusic(const std::string& path) {
+    std::lock_guard<std::mutex> lock(loadMutex);
+    return Mix_LoadMUS(path.c_str());
+}
 
-    Mix_VolumeMusic(static_cast<int>(volume * MIX_MAX_VOLUME));
-    if (Mix_PlayMusic(currentMusic, -1) == -1) {
-        Log::getInstance().error("Failed to play music: " + std::string(Mix_GetError()));
+void SoundManager::post(std::function<void()> call) {
+    Engine* engine = Engine::getInstance();
+    if (!engine) {
+        call();
+        return;
     }
+    engine->getJobSystem().runOnMainThread(std::move(call));
 }
 
-void SoundManager::loopMusic(const std::string& path, float volume, int loops) {
-    if (currentMusic) {
-        Mix_FreeMusic(currentMusic);
+float SoundManager::getDuration(const Mix_Chunk* chunk) {
+    int frequency;
+    Uint16 format;
+    int channels;
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        if (!Mix_QuerySpec(&frequency, &format, &channels)) return 0.0f;
     }
 
-    currentMusic = Mix_LoadMUS(path.c_str());
-    if (!currentMusic) {
-        Log::getInstance().error("Failed to load music: " + std::string(Mix_GetError()));
-        return;
+    int bytesPerSample = 2;
+    if (format == AUDIO_U8 || format == AUDIO_S8) {
+        bytesPerSample = 1;
     }
 
-    Mix_VolumeMusic(static_cast<int>(volume * MIX_MAX_VOLUME));
-    if (Mix_PlayMusic(currentMusic, loops) == -1) {
-        Log::getInstance().error("Failed to play music: " + std::string(Mix_GetError()));
-    }
+    Uint32 points = chunk->alen / (bytesPerSample * channels);
+    return static_cast<float>(points) / static_cast<float>(frequency);
+}
+
+void SoundManager::playMusic(const std::string& path, float volume) {
+    loopMusic(path, volume, -1);
+}
+
+void SoundManager::loopMusic(const std::string& path, float volume, int loops) {
+    post([this, path, volume, loops] {
+        if (currentMusic) {
+            Mix_FreeMusic(currentMusic);
+        }
+        musicPlaying = false;
+
+        currentMusic = loadMusic(path);
+        if (!currentMusic) {
+            Log::getInstance().error("Failed to load music: " + std::string(Mix_GetError()));
+            return;
+        }
+
+        Mix_VolumeMusic(static_cast<int>(volume * MIX_MAX_VOLUME));
+        if (Mix_PlayMusic(currentMusic, loops) == -1) {
+            Log::getInstance().error("Failed to play music: " + std::string(Mix_GetError()));
+            return;
+        }
+        musicPlaying = true;
+    });
 }
 
 void SoundManager::pauseMusic() {
-    if (currentMusic && Mix_PlayingMusic()) {
-        Mix_PauseMusic();
-    }
+    post([this] {
+        if (currentMusic && Mix_PlayingMusic()) {
+            Mix_PauseMusic();
+            musicPlaying = false;
+        }
+    });
 }
 
 void SoundManager::resumeMusic() {
-    if (currentMusic && Mix_PausedMusic()) {
-        Mix_ResumeMusic();
-    }
+    post([this] {
+        if (currentMusic && Mix_PausedMusic()) {
+            Mix_ResumeMusic();
+            musicPlaying = true;
+        }
+    });
 }
 
 void SoundManager::stopMusic() {
-    if (currentMusic) {
-        Mix_HaltMusic();
-    }
+    post([this] {
+        if (currentMusic) {
+            Mix_HaltMusic();
+        }
+        musicPlaying = false;
+    });
 }
 
 void SoundManager::setMusicVolume(float volume) {
-    Mix_VolumeMusic(static_cast<int>(volume * MIX_MAX_VOLUME));
+    post([volume] { Mix_VolumeMusic(static_cast<int>(volume * MIX_MAX_VOLUME)); });
+}
+
+void SoundManager::stopAllSounds() {
+    post([] { Mix_HaltChannel(-1); });
 }
 
 Sound* SoundManager::loadSound(const std::string& path) {
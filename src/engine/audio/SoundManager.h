@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <functional>
 #include <map>
 #include <string>
 #include "Sound.h"
@@ -14,14 +16,30 @@ public:
     void resumeMusic();
     void stopMusic();
     void setMusicVolume(float volume);
+    // Set once queued music has started; cleared by pause and stop. Doesn't
+    // notice music with a loop count running out.
+    bool isMusicPlaying() const { return musicPlaying; }
+    void stopAllSounds();
 
     Sound* loadSound(const std::string& path);
     void playSound(const std::string& path, float volume = 1.0f);
 
+    // SDL_mixer's loaders aren't thread-safe, and sounds are loaded from job
+    // workers, so every Mix_LoadWAV/Mix_LoadMUS goes through these.
+    static Mix_Chunk* loadChunk(const std::string& path);
+    static Mix_Music* loadMusic(const std::string& path);
+    static float getDuration(const Mix_Chunk* chunk);
+
+    // Runs call on the main thread, where mixer playback calls are made; right
+    // away when already there. Calls run in the order they were posted.
+    static void post(std::function<void()> call);
+
 private:
     SoundManager();
     ~SoundManager();
     
     std::map<std::string, Sound*> sounds;
+    // Only touched by posted calls.
     Mix_Music* currentMusic;
+    std::atomic<bool> musicPlaying;
 }; 
\ No newline at end of file
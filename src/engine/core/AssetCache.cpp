@@ -0,0 +1,106 @@
+#include "AssetCache.h"
+#include <SDL2/SDL_image.h>
+#include <fstream>
+#include <sstream>
+#include "../utils/Log.h"
+#include "../graphics/TextureImporter.h"
+#include "../audio/SoundManager.h"
+
+bool AssetCache::preloadImage(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (surfaces.count(path)) return true;
+    }
+
+    // Converting here keeps the format work on the loader thread.
+    SDL_Surface* surface = TextureImporter::decode(path);
+    if (!surface) {
+        return false;
+    }
+    putSurface(path, surface);
+    return true;
+}
+
+SDL_Surface* AssetCache::putSurface(const std::string& path, SDL_Surface* surface) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto inserted = surfaces.emplace(path, surface);
+    if (!inserted.second) {
+        SDL_FreeSurface(surface);
+    }
+    return inserted.first->second;
+}
+
+bool AssetCache::preloadSound(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (chunks.count(path)) return true;
+    }
+
+    Mix_Chunk* chunk = SoundManager::loadChunk(path);
+    if (!chunk) {
+        Log::getInstance().error("Failed to preload sound: " + path + " (" + Mix_GetError() + ")");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto inserted = chunks.emplace(path, chunk);
+    if (!inserted.second) {
+        Mix_FreeChunk(chunk);
+    }
+    return true;
+}
+
+bool AssetCache::preloadText(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (texts.count(path)) return true;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        Log::getInstance().error("Failed to preload file: " + path);
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    texts.emplace(path, buffer.str());
+    return true;
+}
+
+SDL_Surface* AssetCache::getSurface(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = surfaces.find(path);
+    return it != surfaces.end() ? it->second : nullptr;
+}
+
+Mix_Chunk* AssetCache::takeChunk(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = chunks.find(path);
+    if (it == chunks.end()) return nullptr;
+    Mix_Chunk* chunk = it->second;
+    chunks.erase(it);
+    return chunk;
+}
+
+bool AssetCache::getText(const std::string& path, std::string& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = texts.find(path);
+    if (it == texts.end()) return false;
+    out = it->second;
+    return true;
+}
+
+void AssetCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& pair : surfaces) {
+        SDL_FreeSurface(pair.second);
+    }
+    surfaces.clear();
+    for (auto& pair : chunks) {
+        Mix_FreeChunk(pair.second);
+    }
+    chunks.clear();
+    texts.clear();
+}
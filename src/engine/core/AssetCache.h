@@ -0,0 +1,57 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Files a State wants decoded before it is created. Paths are the same strings
+// the state later hands to Sprite/AnimatedSprite/Sound, so the loaders find them.
+struct AssetManifest {
+    std::vector<std::string> images;
+    std::vector<std::string> sounds;
+    std::vector<std::string> texts;
+
+    size_t size() const { return images.size() + sounds.size() + texts.size(); }
+    bool empty() const { return size() == 0; }
+};
+
+// Holds CPU-side decoded assets between a transition's preload and the new
+// state's create(). The preload* calls are safe from worker threads; only the
+// texture upload that follows has to happen on the main thread.
+class AssetCache {
+public:
+    static AssetCache& getInstance() {
+        static AssetCache instance;
+        return instance;
+    }
+
+    bool preloadImage(const std::string& path);
+    bool preloadSound(const std::string& path);
+    bool preloadText(const std::string& path);
+
+    // Still owned by the cache; valid until clear(). Surfaces are already
+    // imported (see TextureImporter).
+    SDL_Surface* getSurface(const std::string& path);
+    // Takes ownership; returns the cached surface, which is an earlier one for
+    // path if another thread got there first.
+    SDL_Surface* putSurface(const std::string& path, SDL_Surface* surface);
+    // Ownership moves to the caller, who frees it with Mix_FreeChunk.
+    Mix_Chunk* takeChunk(const std::string& path);
+    bool getText(const std::string& path, std::string& out);
+
+    // Frees everything not taken. Called once the new state has been created.
+    void clear();
+
+private:
+    AssetCache() = default;
+    ~AssetCache() { clear(); }
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    std::mutex mutex;
+    std::map<std::string, SDL_Surface*> surfaces;
+    std::map<std::string, Mix_Chunk*> chunks;
+    std::map<std::string, std::string> texts;
+};
@@ -5,24 +5,38 @@
 #include "../graphics/Sprite.h"
 #include "../graphics/AnimatedSprite.h"
 #include "../graphics/Text.h"
+#include "../graphics/FontAtlas.h"
+#include "../graphics/VideoExporter.h"
+#include "../graphics/MipChain.h"
 #include "../input/Input.h"
 #include <SDL2/SDL_mixer.h>
 #include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
 #include "../utils/Log.h"
 
 Engine* Engine::instance = nullptr;
 
-Engine::Engine(int width, int height, const char* title, int fps)
-    : windowWidth(width), windowHeight(height), running(true), fps(fps) {
+Engine::Engine(int width, int height, const char* title, int fps, bool headless)
+    : windowWidth(width), windowHeight(height), running(true), fps(fps), jobSystem(nullptr), headless(headless) {
     if (instance == nullptr) {
         instance = this;
     }
 
-    if (!SDLManager::getInstance().initialize(width, height, title)) {
+    jobSystem = new JobSystem();
+
+    if (!SDLManager::getInstance().initialize(width, height, title, headless)) {
         std::cerr << "Failed to initialize SDL!" << std::endl;
         return;
     }
 
+    if (headless) {
+        // Deterministic frames that don't depend on SDL's software blitter.
+        Renderer::getInstance().setSoftwareCompositing(true);
+    }
+    Renderer::getInstance().configureTextures();
+
     if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
         std::cerr << "Failed to initialize SDL_mixer: " << Mix_GetError() << std::endl;
         return;
@@ -30,50 +44,222 @@ Engine::Engine(int width, int height, const char* title, int fps)
 
     Input::initController();
 
-    frameDelay = 1000 / fps;
     debugUI = new DebugUI();
 }
 
 Engine::~Engine() {
-    Mix_CloseAudio();
-    
-    for (auto sprite : sprites) {
-        delete sprite;
-    }
-    for (auto animatedSprite : animatedSprites) {
-        delete animatedSprite;
-    }
-    for (auto text : texts) {
-        delete text;
+    cancelTransition();
+    while (!states.empty()) {
+        states.top()->destroy();
+        retiredStates.push_back(states.top());
+        states.pop();
     }
+    deleteRetiredStates();
+    clearAllSprites();
+
+    Mix_CloseAudio();
 
     delete debugUI;
+    FontAtlas::clearCache();
+    Renderer::getInstance().flushDestroyedTextures();
+    Renderer::getInstance().setSoftwareCompositing(false);
+    delete jobSystem;
+
+    if (instance == this) {
+        instance = nullptr;
+    }
 }
 
 void Engine::run() {
-    const float frameDelay = 1000.0f / fps;
-    Uint32 frameStart;
-    float frameTime;
+    if (threadedRendering) {
+        runThreaded();
+        return;
+    }
+
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 previousCounter = SDL_GetPerformanceCounter();
+    configurePacer();
 
     while (running) {
-        frameStart = SDL_GetTicks();
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        double frameTime = static_cast<double>(frameStart - previousCounter) / frequency;
+        previousCounter = frameStart;
+
+        handleEvents();
+        jobSystem->drainMainThreadQueue();
+
+        simulateFrame(frameTime);
+        presentLatestSnapshot();
+        pacer.waitForNextFrame();
+    }
+
+    if (headless) {
+        logFrameTimings();
+    }
+}
+
+void Engine::runThreaded() {
+    simulationFinished = false;
+    configurePacer();
+
+    std::thread simulation([this] {
+        const Uint64 frequency = SDL_GetPerformanceFrequency();
+        Uint64 previousCounter = SDL_GetPerformanceCounter();
 
+        while (running) {
+            Uint64 frameStart = SDL_GetPerformanceCounter();
+            double frameTime = static_cast<double>(frameStart - previousCounter) / frequency;
+            previousCounter = frameStart;
+
+            simulateFrame(frameTime);
+            pacer.waitForNextFrame();
+        }
+        simulationFinished = true;
+    });
+
+    // This thread owns the window: it pumps events, runs the texture uploads the
+    // simulation hands over, and presents whatever snapshot is newest. It never
+    // waits on the simulation, so the simulation can safely block on it.
+    while (!simulationFinished) {
         handleEvents();
-        update();
-        render();
+        jobSystem->drainMainThreadQueue();
+        if (!presentLatestSnapshot()) {
+            SDL_Delay(1);
+        }
+    }
+
+    simulation.join();
+    jobSystem->drainMainThreadQueue();
+    Renderer::getInstance().flushDestroyedTextures();
+
+    if (headless) {
+        logFrameTimings();
+    }
+}
+
+void Engine::setFramePacing(FramePacing mode, int frameRate) {
+    framePacing = mode;
+    if (frameRate > 0) {
+        fps = frameRate;
+    }
+    if (!headless && !SDLManager::getInstance().setVSync(mode == FramePacing::VSync) && mode == FramePacing::VSync) {
+        Log::getInstance().warning("VSync unavailable, capping at " + std::to_string(fps) + " fps");
+        framePacing = FramePacing::Capped;
+    }
+    configurePacer();
+}
 
-        frameTime = SDL_GetTicks() - frameStart;
-        if (frameDelay > frameTime) {
-            SDL_Delay(frameDelay - frameTime);
+void Engine::configurePacer() {
+    int rate = 0;
+    if (framePacing == FramePacing::Capped) {
+        rate = fps;
+    } else if (framePacing == FramePacing::VSync && threadedRendering) {
+        // Present blocks the main thread, not the simulation; keep the simulation
+        // producing about one snapshot per refresh instead of spinning.
+        int refreshRate = SDLManager::getInstance().getRefreshRate();
+        rate = refreshRate > 0 ? refreshRate : fps;
+    }
+    // Headless frames run on the virtual clock and never wait.
+    pacer.setTargetRate(headless ? 0 : rate);
+}
+
+void Engine::simulateFrame(double frameTime) {
+    deleteRetiredStates();
+    updateTransition();
+
+    if (headless) {
+        frameTime = 1.0 / fps;
+        virtualTime += frameTime;
+        virtualTicks.store(static_cast<Uint32>(virtualTime * 1000.0), std::memory_order_relaxed);
+    }
+
+    Uint64 updateStart = SDL_GetPerformanceCounter();
+    int steps = 0;
+    if (fixedTimestep) {
+        // Clamp so a long hitch (window drag, breakpoint) doesn't turn into a burst of updates.
+        accumulator += std::min(frameTime, fixedDelta * maxCatchUpSteps);
+
+        while (accumulator >= fixedDelta && steps < maxCatchUpSteps) {
+            update(static_cast<float>(fixedDelta));
+            accumulator -= fixedDelta;
+            steps++;
+        }
+        if (steps == maxCatchUpSteps && accumulator >= fixedDelta) {
+            accumulator = std::fmod(accumulator, fixedDelta);
         }
+    } else {
+        update(static_cast<float>(frameTime));
+    }
+
+    Uint64 renderStart = SDL_GetPerformanceCounter();
+    Renderer& renderer = Renderer::getInstance();
+    renderer.beginRecording(snapshots.beginWrite());
+    render(fixedTimestep ? static_cast<float>(accumulator / fixedDelta) : 1.0f);
+    renderer.endRecording();
+    MipChain::evictUnused(getTicks());
+    snapshots.publish();
+    Uint64 frameEnd = SDL_GetPerformanceCounter();
+
+    updateCounterTotal += renderStart - updateStart;
+    renderCounterTotal += frameEnd - renderStart;
+    frameCount++;
+
+    if (maxFrames > 0 && frameCount >= maxFrames) {
+        quit();
     }
 }
 
-void Engine::update() {
-    static float lastTime = SDL_GetTicks() / 1000.0f;
-    float currentTime = SDL_GetTicks() / 1000.0f;
-    deltaTime = currentTime - lastTime;
-    lastTime = currentTime;
+bool Engine::presentLatestSnapshot() {
+    const RenderSnapshot* snapshot = snapshots.acquire();
+    if (!snapshot) return false;
+
+    Uint64 presentStart = SDL_GetPerformanceCounter();
+    Renderer::getInstance().replay(*snapshot);
+    if (videoExporter) {
+        videoExporter->captureFrame(SDLManager::getInstance().getRenderer());
+    }
+    SDLManager::getInstance().present();
+    presentCounterTotal += SDL_GetPerformanceCounter() - presentStart;
+    framesPresented++;
+    return true;
+}
+
+Uint32 Engine::getTicks() const {
+    if (headless) {
+        return virtualTicks.load(std::memory_order_relaxed);
+    }
+    return SDL_GetTicks();
+}
+
+void Engine::logFrameTimings() const {
+    if (frameCount == 0) return;
+
+    const double toMs = 1000.0 / SDL_GetPerformanceFrequency();
+    double updateMs = updateCounterTotal * toMs / frameCount;
+    double renderMs = renderCounterTotal * toMs / frameCount;
+    double presentMs = framesPresented > 0 ? presentCounterTotal * toMs / framesPresented : 0.0;
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3)
+       << "Headless run: " << frameCount << " frames, " << virtualTime << "s simulated, "
+       << "avg update " << updateMs << " ms, avg record " << renderMs << " ms, "
+       << framesPresented << " presented, avg present " << presentMs << " ms";
+    if (SoftwareCompositor* software = Renderer::getInstance().getSoftwareCompositor()) {
+        ss << ", last frame hash " << std::hex << software->getFrameHash();
+    }
+    Log::getInstance().info(ss.str());
+}
+
+void Engine::setFixedTimestep(int rate, int maxSteps) {
+    fixedTimestep = rate > 0;
+    updateRate = fixedTimestep ? rate : 0;
+    maxCatchUpSteps = std::max(1, maxSteps);
+    fixedDelta = fixedTimestep ? 1.0 / rate : 0.0;
+    accumulator = 0.0;
+}
+
+void Engine::update(float deltaTime) {
+    this->deltaTime = deltaTime;
 
     if (!states.empty()) {
         State* currentState = states.top();
@@ -88,32 +274,42 @@ void Engine::update() {
     }
 }
 
-void Engine::render() {
-    SDLManager::getInstance().clear();
+void Engine::render(float alpha) {
+    interpolationAlpha = alpha;
+    Renderer& renderer = Renderer::getInstance();
+    renderer.setLayer(RenderLayer::Background);
+    renderer.clear(0, 0, 0, 255);
+    renderer.setLayer(RenderLayer::World);
 
     if (!states.empty()) {
         State* currentState = states.top();
         if (currentState) {
-            currentState->render();
+            currentState->renderInterpolated(alpha);
         }
     }
 
     if (debugMode && debugUI) {
+        renderer.setLayer(RenderLayer::Overlay);
         debugUI->render();
     }
-
-    SDLManager::getInstance().present();
 }
 
 void Engine::handleEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
+        // Headless runs judge input against the virtual clock.
+        Input::queueEvent(event, headless ? getTicks() : event.common.timestamp);
         switch (event.type) {
             case SDL_QUIT:
                 quit();
                 break;
+            case SDL_RENDER_TARGETS_RESET:
+            case SDL_RENDER_DEVICE_RESET:
+                Renderer::getInstance().notifyTargetsReset();
+                break;
         }
     }
+    Input::pollControllers(getTicks());
 }
 
 void Engine::quit() {
@@ -122,13 +318,13 @@ void Engine::quit() {
 
 void Engine::pushState(State* state) {
     states.push(state);
-    state->create();
+    enterState(state);
 }
 
 void Engine::popState() {
     if (!states.empty()) {
         states.top()->destroy();
-        delete states.top();
+        retiredStates.push_back(states.top());
         states.pop();
     }
 }
@@ -139,44 +335,89 @@ void Engine::switchState(State* state) {
         states.pop();
         
         oldState->destroy();
-        //delete oldState; // Errr causes a crash in playstate lol
-        
-        try {
-            for (size_t i = 0; i < sprites.size(); ++i) {
-                if (sprites[i]) {
-                    delete sprites[i];
-                    sprites[i] = nullptr;
-                }
-            }
-            sprites.clear();
-            
-            for (size_t i = 0; i < animatedSprites.size(); ++i) {
-                if (animatedSprites[i]) {
-                    delete animatedSprites[i];
-                    animatedSprites[i] = nullptr;
-                }
-            }
-            animatedSprites.clear();
-            
-            for (size_t i = 0; i < texts.size(); ++i) {
-                if (texts[i]) {
-                    delete texts[i];
-                    texts[i] = nullptr;
-                }
-            }
-            texts.clear();
-            
-        } catch (const std::exception& e) {
-            Log::getInstance().error("Exception while clearing resources: " + std::string(e.what()));
-        } catch (...) {
-            Log::getInstance().error("Unknown exception while clearing resources");
-        }
+        retiredStates.push_back(oldState);
+        clearAllSprites();
     }
     
     states.push(state);
+    enterState(state);
+}
+
+void Engine::enterState(State* state) {
+    if (!state->preloaded) {
+        state->preload();
+        state->preloaded = true;
+    }
+    // Presses made while the previous state was up (or loading) belong to it.
+    Input::discardEvents();
     state->create();
 }
 
+void Engine::transitionTo(State* state, State* loadingScreen) {
+    if (pendingState) {
+        Log::getInstance().warning("Transition already in progress, dropping new request");
+        delete state;
+        delete loadingScreen;
+        return;
+    }
+
+    AssetManifest manifest;
+    state->declareAssets(manifest);
+
+    AssetCache& cache = AssetCache::getInstance();
+    for (const std::string& path : manifest.images) {
+        pendingLoads.push_back(jobSystem->schedule([&cache, path] { cache.preloadImage(path); }));
+    }
+    for (const std::string& path : manifest.sounds) {
+        pendingLoads.push_back(jobSystem->schedule([&cache, path] { cache.preloadSound(path); }));
+    }
+    for (const std::string& path : manifest.texts) {
+        pendingLoads.push_back(jobSystem->schedule([&cache, path] { cache.preloadText(path); }));
+    }
+    // preload() may pick up what the manifest decoded, so it waits for all of it.
+    pendingLoads.push_back(jobSystem->schedule([state] {
+        state->preload();
+        state->preloaded = true;
+    }, pendingLoads));
+
+    pendingState = state;
+    if (loadingScreen) {
+        switchState(loadingScreen);
+    }
+}
+
+float Engine::getTransitionProgress() const {
+    if (pendingLoads.empty()) return pendingState ? 0.0f : 1.0f;
+    size_t done = 0;
+    for (const JobHandle& job : pendingLoads) {
+        if (job.isDone()) done++;
+    }
+    return static_cast<float>(done) / pendingLoads.size();
+}
+
+void Engine::updateTransition() {
+    if (!pendingState) return;
+    for (const JobHandle& job : pendingLoads) {
+        if (!job.isDone()) return;
+    }
+
+    State* state = pendingState;
+    pendingState = nullptr;
+    pendingLoads.clear();
+
+    switchState(state);
+    AssetCache::getInstance().clear();
+}
+
+void Engine::cancelTransition() {
+    if (!pendingState) return;
+    jobSystem->waitAll(pendingLoads);
+    pendingLoads.clear();
+    delete pendingState;
+    pendingState = nullptr;
+    AssetCache::getInstance().clear();
+}
+
 void Engine::openSubState(SubState* subState) {
     std::cout << "Engine::openSubState called" << std::endl;
     if (!states.empty()) {
@@ -186,21 +427,22 @@ void Engine::openSubState(SubState* subState) {
     }
 }
 
-void Engine::setTimeout(std::function<void()> callback, float seconds) {
-    Timeout timeout;
-    timeout.callback = callback;
-    timeout.remainingTime = seconds;
-    timeouts.push_back(timeout);
+void Engine::deleteRetiredStates() {
+    for (State* state : retiredStates) {
+        const MemoryArena& arena = state->getArena();
+        if (arena.getHighWater() > 0) {
+            Log::getInstance().info("State arena: " + std::to_string(arena.getObjectCount()) + " objects, " +
+                                    std::to_string(arena.getHighWater() / 1024) + " KB high water, " +
+                                    std::to_string(arena.getBytesReserved() / 1024) + " KB reserved");
+        }
+        delete state;
+    }
+    retiredStates.clear();
 }
 
 void Engine::updateTimeouts(float deltaTime) {
-    for (auto it = timeouts.begin(); it != timeouts.end();) {
-        it->remainingTime -= deltaTime;
-        if (it->remainingTime <= 0) {
-            it->callback();
-            it = timeouts.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    timeoutRemainder += deltaTime * 1000.0;
+    uint64_t ticks = static_cast<uint64_t>(timeoutRemainder);
+    timeoutRemainder -= static_cast<double>(ticks);
+    timeouts.advance(ticks);
 }
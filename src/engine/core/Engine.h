@@ -2,38 +2,88 @@
 
 #include <vector>
 #include <stack>
+#include <algorithm>
 #include "../graphics/Sprite.h"
 #include "../graphics/AnimatedSprite.h"
 #include "../graphics/Text.h"
 #include "../audio/SoundManager.h"
 #include "SDLManager.h"
 #include "../debug/DebugUI.h"
+#include "TimerWheel.h"
+#include "JobSystem.h"
+#include "FramePacer.h"
+#include "HandleRegistry.h"
+#include "AssetCache.h"
+#include "../graphics/Renderer.h"
+#include "../graphics/RenderSnapshot.h"
+#include <atomic>
 #include <functional>
 
 class State;
 class SubState;
+class VideoExporter;
+
+using SpriteHandle = ObjectHandle<Sprite>;
+using AnimatedSpriteHandle = ObjectHandle<AnimatedSprite>;
+using TextHandle = ObjectHandle<Text>;
 
 class Engine {
 public:
-    Engine(int width, int height, const char* title, int fps);
+    Engine(int width, int height, const char* title, int fps, bool headless = false);
     ~Engine();
 
     void run();
-    void update();
-    void render();
+    void update(float deltaTime);
+    void render(float alpha = 1.0f);
     void quit();
 
+    // updateRate <= 0 falls back to one variable-length update per rendered frame.
+    void setFixedTimestep(int updateRate, int maxCatchUpSteps = 8);
+    bool isFixedTimestep() const { return fixedTimestep; }
+    int getUpdateRate() const { return updateRate; }
+    float getInterpolationAlpha() const { return interpolationAlpha; }
+
+    // Render pacing, independent of the update rate above. frameRate is the cap for
+    // Capped (and the headless frame length); 0 keeps the current rate.
+    void setFramePacing(FramePacing mode, int frameRate = 0);
+    FramePacing getFramePacing() const { return framePacing; }
+    int getFrameRate() const { return fps; }
+
+    // Runs update/record on a simulation thread while this thread only pumps
+    // events and replays the newest render snapshot, so a blocking present
+    // (vsync) no longer delays input sampling or the next update. Set before run().
+    void setThreadedRendering(bool enabled) { threadedRendering = enabled; }
+    bool isThreadedRendering() const { return threadedRendering; }
+
     static Engine* getInstance() { return instance; }
 
-    void addSprite(Sprite* sprite) { sprites.push_back(sprite); }
-    void addAnimatedSprite(AnimatedSprite* sprite) { animatedSprites.push_back(sprite); }
-    void addText(Text* text) { texts.push_back(text); }
+    // The engine takes ownership; everything added is freed on the next switchState.
+    SpriteHandle addSprite(Sprite* sprite) { return sprites.add(sprite); }
+    AnimatedSpriteHandle addAnimatedSprite(AnimatedSprite* sprite) { return animatedSprites.add(sprite); }
+    TextHandle addText(Text* text) { return texts.add(text); }
+
+    bool removeSprite(SpriteHandle handle) { return sprites.remove(handle); }
+    bool removeAnimatedSprite(AnimatedSpriteHandle handle) { return animatedSprites.remove(handle); }
+    bool removeText(TextHandle handle) { return texts.remove(handle); }
+
+    Sprite* getSprite(SpriteHandle handle) const { return sprites.get(handle); }
+    AnimatedSprite* getAnimatedSprite(AnimatedSpriteHandle handle) const { return animatedSprites.get(handle); }
+    Text* getText(TextHandle handle) const { return texts.get(handle); }
 
     void pushState(State* state);
     void popState();
     void switchState(State* state);
     void openSubState(SubState* subState);
 
+    // Decodes the state's manifest and runs its preload() on the job system, then
+    // switches to it on a later frame with only create() (texture uploads) left on
+    // this thread. Until then the current state keeps running, or loadingScreen
+    // replaces it if given. Requests made while one is in flight are dropped.
+    void transitionTo(State* state, State* loadingScreen = nullptr);
+    bool isTransitioning() const { return pendingState != nullptr; }
+    // Fraction of the pending transition's load jobs that have finished.
+    float getTransitionProgress() const;
+
     int getWindowWidth() const { return windowWidth; }
     int getWindowHeight() const { return windowHeight; }
 
@@ -50,14 +100,36 @@ public:
     }
 
     SoundManager& getSoundManager() { return SoundManager::getInstance(); }
-
-    const std::vector<Sprite*>& getSprites() const { return sprites; }
-    const std::vector<AnimatedSprite*>& getAnimatedSprites() const { return animatedSprites; }
-
-    void setTimeout(std::function<void()> callback, float seconds);
+    JobSystem& getJobSystem() { return *jobSystem; }
+
+    const std::vector<Sprite*>& getSprites() const { return sprites.objects(); }
+    const std::vector<AnimatedSprite*>& getAnimatedSprites() const { return animatedSprites.objects(); }
+    const std::vector<Text*>& getTexts() const { return texts.objects(); }
+
+    // Timeouts run on a millisecond timer wheel; the callback is stored inline,
+    // so its captures must fit in TimerWheel::CALLBACK_SIZE bytes.
+    template <typename F>
+    TimerHandle setTimeout(F&& callback, float seconds) {
+        uint64_t delay = static_cast<uint64_t>(std::max(0.0f, seconds) * 1000.0f + 0.5f);
+        return timeouts.schedule(delay, std::forward<F>(callback));
+    }
+    bool clearTimeout(TimerHandle handle) { return timeouts.cancel(handle); }
     void updateTimeouts(float deltaTime);
 
-    float getCurrentTime() const { return SDL_GetTicks() / 1000.0f; }
+    // Milliseconds since startup. Headless runs read a virtual clock that advances
+    // exactly one frame per loop, so results don't depend on host speed.
+    Uint32 getTicks() const;
+    float getCurrentTime() const { return getTicks() / 1000.0f; }
+
+    bool isHeadless() const { return headless; }
+    // Stops run() after this many frames; 0 runs until quit().
+    void setMaxFrames(Uint64 frames) { maxFrames = frames; }
+    bool hasMaxFrames() const { return maxFrames > 0; }
+    Uint64 getFrameCount() const { return frameCount; }
+    // Every presented frame is handed to the exporter; not owned. Use with
+    // headless, unthreaded runs so each simulated frame is presented once.
+    void setVideoExporter(VideoExporter* exporter) { videoExporter = exporter; }
+    VideoExporter* getVideoExporter() const { return videoExporter; }
 
     bool debugMode;
 
@@ -65,21 +137,59 @@ private:
     static Engine* instance;
     int windowWidth;
     int windowHeight;
-    std::vector<Sprite*> sprites;
-    std::vector<AnimatedSprite*> animatedSprites;
-    std::vector<Text*> texts;
+    HandleRegistry<Sprite> sprites;
+    HandleRegistry<AnimatedSprite> animatedSprites;
+    HandleRegistry<Text> texts;
     float deltaTime;
     std::stack<State*> states;
-    bool running;
+    // States leave the stack from inside their own update(), so they are deleted
+    // at the top of the next frame instead.
+    std::vector<State*> retiredStates;
+    State* pendingState = nullptr;
+    std::vector<JobHandle> pendingLoads;
+    std::atomic<bool> running;
     int fps;
-    int frameDelay;
+    FramePacing framePacing = FramePacing::VSync;
+    FramePacer pacer;
     DebugUI* debugUI;
-
-    struct Timeout {
-        std::function<void()> callback;
-        float remainingTime;
-    };
-    std::vector<Timeout> timeouts;
+    JobSystem* jobSystem;
+
+    bool fixedTimestep = false;
+    int updateRate = 0;
+    int maxCatchUpSteps = 8;
+    double fixedDelta = 0.0;
+    double accumulator = 0.0;
+    float interpolationAlpha = 1.0f;
+
+    bool headless = false;
+    VideoExporter* videoExporter = nullptr;
+    double virtualTime = 0.0;
+    // virtualTime in ms, for getTicks() from the main thread (input timestamps).
+    std::atomic<Uint32> virtualTicks{ 0 };
+    Uint64 frameCount = 0;
+    Uint64 maxFrames = 0;
+    Uint64 updateCounterTotal = 0;
+    Uint64 renderCounterTotal = 0;
+    Uint64 presentCounterTotal = 0;
+    Uint64 framesPresented = 0;
+
+    void logFrameTimings() const;
+
+    TimerWheel timeouts;
+    double timeoutRemainder = 0.0;
+
+    bool threadedRendering = false;
+    std::atomic<bool> simulationFinished{ false };
+    RenderSnapshotBuffer snapshots;
+
+    void configurePacer();
+    void simulateFrame(double frameTime);
+    bool presentLatestSnapshot();
+    void runThreaded();
 
     void handleEvents();
+    void deleteRetiredStates();
+    void enterState(State* state);
+    void updateTransition();
+    void cancelTransition();
 };
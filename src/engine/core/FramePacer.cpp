@@ -0,0 +1,47 @@
+#include "FramePacer.h"
+#include <SDL2/SDL_atomic.h>
+#include <algorithm>
+
+static constexpr double MIN_SLEEP_SLACK = 0.0005;
+static constexpr double MAX_SLEEP_SLACK = 0.004;
+
+FramePacer::FramePacer() : frequency(SDL_GetPerformanceFrequency()) {}
+
+void FramePacer::setTargetRate(int framesPerSecond) {
+    targetRate = std::max(0, framesPerSecond);
+    period = targetRate > 0 ? frequency / targetRate : 0;
+    reset();
+}
+
+void FramePacer::waitForNextFrame() {
+    if (period == 0) return;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (nextDeadline == 0) {
+        nextDeadline = now;
+    }
+    nextDeadline += period;
+    if (now >= nextDeadline) {
+        nextDeadline = now;
+        return;
+    }
+
+    // Sleep in whole milliseconds while there's comfortably more than the slack left.
+    for (;;) {
+        now = SDL_GetPerformanceCounter();
+        double remaining = static_cast<double>(nextDeadline - std::min(now, nextDeadline)) / frequency;
+        Uint32 sleepMs = static_cast<Uint32>((remaining - sleepSlack) * 1000.0);
+        if (remaining <= sleepSlack || sleepMs == 0) break;
+
+        SDL_Delay(sleepMs);
+        double slept = static_cast<double>(SDL_GetPerformanceCounter() - now) / frequency;
+        double oversleep = slept - sleepMs / 1000.0;
+        // Grow immediately on a late wake-up, shrink slowly when sleeps are accurate.
+        sleepSlack = oversleep > sleepSlack ? oversleep : sleepSlack * 0.95 + oversleep * 0.05;
+        sleepSlack = std::clamp(sleepSlack, MIN_SLEEP_SLACK, MAX_SLEEP_SLACK);
+    }
+
+    while (SDL_GetPerformanceCounter() < nextDeadline) {
+        SDL_CPUPauseInstruction();
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <SDL2/SDL.h>
+
+enum class FramePacing {
+    VSync,      // present blocks on the display; no software limiter
+    Unlocked,   // no limiter at all
+    Capped      // software limiter at a fixed rate
+};
+
+// Software frame limiter. SDL_Delay alone oversleeps by up to a scheduler tick,
+// so this sleeps for most of the remaining time and spins on the performance
+// counter for the rest. The spin margin tracks how late recent sleeps woke up.
+class FramePacer {
+public:
+    FramePacer();
+
+    // <= 0 disables waiting.
+    void setTargetRate(int framesPerSecond);
+    int getTargetRate() const { return targetRate; }
+
+    // Restarts the schedule from now, e.g. after a hitch or a mode change.
+    void reset() { nextDeadline = 0; }
+
+    // Blocks until the next frame deadline. Deadlines advance by a fixed period,
+    // so timing error does not accumulate; a missed one resyncs instead of rushing.
+    void waitForNextFrame();
+
+    double getSleepSlack() const { return sleepSlack; }
+
+private:
+    Uint64 frequency;
+    Uint64 period = 0;
+    Uint64 nextDeadline = 0;
+    int targetRate = 0;
+    double sleepSlack = 0.002;
+};
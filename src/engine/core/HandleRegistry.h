@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stable reference into a HandleRegistry<T>. The generation changes every time a
+// slot is reused, so a handle to a removed object never aliases a newer one.
+template <typename T>
+struct ObjectHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == UINT32_MAX; }
+    bool operator==(const ObjectHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+};
+
+// Slot map that owns heap objects of one type. Live objects are kept packed in a
+// dense array for iteration; slots map handles to dense positions, so add, remove
+// and validation are O(1). Removal swaps the last object into the hole, so
+// iteration order is not insertion order.
+template <typename T>
+class HandleRegistry {
+public:
+    using Handle = ObjectHandle<T>;
+
+    HandleRegistry() = default;
+    HandleRegistry(const HandleRegistry&) = delete;
+    HandleRegistry& operator=(const HandleRegistry&) = delete;
+    ~HandleRegistry() { clear(); }
+
+    Handle add(T* object) {
+        if (!object) return Handle();
+
+        uint32_t slotIndex;
+        if (!freeSlots.empty()) {
+            slotIndex = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slotIndex = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot());
+        }
+
+        Slot& slot = slots[slotIndex];
+        slot.denseIndex = static_cast<uint32_t>(dense.size());
+        dense.push_back(object);
+        denseToSlot.push_back(slotIndex);
+        return Handle{ slotIndex, slot.generation };
+    }
+
+    bool isValid(Handle handle) const {
+        return handle.index < slots.size() &&
+               slots[handle.index].generation == handle.generation &&
+               slots[handle.index].denseIndex != NONE;
+    }
+
+    T* get(Handle handle) const {
+        return isValid(handle) ? dense[slots[handle.index].denseIndex] : nullptr;
+    }
+
+    // Removes and deletes the object. Returns false for stale handles.
+    bool remove(Handle handle) {
+        T* object = release(handle);
+        delete object;
+        return object != nullptr;
+    }
+
+    // Removes the object without deleting it; ownership goes back to the caller.
+    T* release(Handle handle) {
+        if (!isValid(handle)) return nullptr;
+
+        Slot& slot = slots[handle.index];
+        uint32_t hole = slot.denseIndex;
+        T* object = dense[hole];
+
+        uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+        if (hole != last) {
+            dense[hole] = dense[last];
+            denseToSlot[hole] = denseToSlot[last];
+            slots[denseToSlot[hole]].denseIndex = hole;
+        }
+        dense.pop_back();
+        denseToSlot.pop_back();
+
+        slot.denseIndex = NONE;
+        slot.generation++;
+        freeSlots.push_back(handle.index);
+        return object;
+    }
+
+    // Deletes every object in one pass and invalidates all outstanding handles.
+    void clear() {
+        std::vector<T*> doomed;
+        doomed.swap(dense);
+        denseToSlot.clear();
+
+        freeSlots.clear();
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            if (slots[i].denseIndex != NONE) {
+                slots[i].denseIndex = NONE;
+                slots[i].generation++;
+            }
+            freeSlots.push_back(static_cast<uint32_t>(slots.size() - 1 - i));
+        }
+
+        for (T* object : doomed) {
+            delete object;
+        }
+    }
+
+    const std::vector<T*>& objects() const { return dense; }
+    size_t size() const { return dense.size(); }
+    bool empty() const { return dense.empty(); }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Slot {
+        uint32_t denseIndex = NONE;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<T*> dense;
+    std::vector<uint32_t> denseToSlot;
+};
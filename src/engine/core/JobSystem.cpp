@@ -0,0 +1,214 @@
+#include "JobSystem.h"
+#include "../utils/Log.h"
+
+struct JobHandle::Job {
+    JobSystem::JobFunction work;
+    // Unfinished dependencies, plus one held while the job is being set up.
+    std::atomic<int> pendingDependencies{ 1 };
+    std::mutex mutex;
+    bool done = false;
+    std::vector<std::shared_ptr<Job>> continuations;
+};
+
+namespace {
+    thread_local int currentWorkerIndex = -1;
+}
+
+bool JobHandle::isDone() const {
+    if (!job) return true;
+    std::lock_guard<std::mutex> lock(job->mutex);
+    return job->done;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+    : mainThreadId(std::this_thread::get_id()) {
+    if (workerCount == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 1;
+    }
+
+    for (unsigned int i = 0; i < workerCount; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    Log::getInstance().info("Job system started with " + std::to_string(workerCount) + " workers");
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+JobHandle JobSystem::schedule(JobFunction work) {
+    return schedule(std::move(work), std::vector<JobHandle>());
+}
+
+JobHandle JobSystem::schedule(JobFunction work, std::initializer_list<JobHandle> dependencies) {
+    return schedule(std::move(work), std::vector<JobHandle>(dependencies));
+}
+
+JobHandle JobSystem::schedule(JobFunction work, const std::vector<JobHandle>& dependencies) {
+    JobPtr job = std::make_shared<JobHandle::Job>();
+    job->work = std::move(work);
+
+    for (const JobHandle& dependency : dependencies) {
+        addDependency(job, dependency);
+    }
+    releaseDependency(job);
+
+    return JobHandle(job);
+}
+
+void JobSystem::addDependency(const JobPtr& job, const JobHandle& dependency) {
+    if (!dependency.job) return;
+
+    std::lock_guard<std::mutex> lock(dependency.job->mutex);
+    if (!dependency.job->done) {
+        job->pendingDependencies.fetch_add(1);
+        dependency.job->continuations.push_back(job);
+    }
+}
+
+void JobSystem::releaseDependency(const JobPtr& job) {
+    if (job->pendingDependencies.fetch_sub(1) == 1) {
+        enqueue(job);
+    }
+}
+
+void JobSystem::enqueue(JobPtr job) {
+    unsigned int index = currentWorkerIndex >= 0
+        ? static_cast<unsigned int>(currentWorkerIndex)
+        : nextQueue.fetch_add(1) % static_cast<unsigned int>(queues.size());
+
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->jobs.push_back(std::move(job));
+    }
+    queuedJobs.fetch_add(1);
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_one();
+}
+
+JobSystem::JobPtr JobSystem::popLocal(unsigned int index) {
+    WorkQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return nullptr;
+    JobPtr job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    queuedJobs.fetch_sub(1);
+    return job;
+}
+
+JobSystem::JobPtr JobSystem::steal(unsigned int thiefIndex) {
+    size_t count = queues.size();
+    for (size_t i = 1; i <= count; i++) {
+        WorkQueue& queue = *queues[(thiefIndex + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            JobPtr job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(const JobPtr& job) {
+    try {
+        if (job->work) {
+            job->work();
+        }
+    } catch (const std::exception& e) {
+        Log::getInstance().error("Exception in job: " + std::string(e.what()));
+    } catch (...) {
+        Log::getInstance().error("Unknown exception in job");
+    }
+    job->work = nullptr;
+
+    std::vector<JobPtr> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->done = true;
+        continuations.swap(job->continuations);
+    }
+    for (const JobPtr& continuation : continuations) {
+        releaseDependency(continuation);
+    }
+}
+
+bool JobSystem::runOneJob() {
+    JobPtr job;
+    if (currentWorkerIndex >= 0) {
+        job = popLocal(static_cast<unsigned int>(currentWorkerIndex));
+        if (!job) job = steal(static_cast<unsigned int>(currentWorkerIndex));
+    } else {
+        job = steal(nextQueue.load() % static_cast<unsigned int>(queues.size()));
+    }
+
+    if (!job) return false;
+    execute(job);
+    return true;
+}
+
+void JobSystem::workerLoop(unsigned int index) {
+    currentWorkerIndex = static_cast<int>(index);
+
+    while (true) {
+        if (runOneJob()) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this] { return stopping || queuedJobs.load() > 0; });
+        if (stopping && queuedJobs.load() == 0) break;
+    }
+}
+
+void JobSystem::wait(const JobHandle& handle) {
+    while (!handle.isDone()) {
+        if (isMainThread() && drainMainThreadQueue() > 0) continue;
+        if (!runOneJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::waitAll(const std::vector<JobHandle>& jobs) {
+    for (const JobHandle& job : jobs) {
+        wait(job);
+    }
+}
+
+void JobSystem::runOnMainThread(JobFunction work) {
+    if (isMainThread()) {
+        work();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mainThreadMutex);
+    mainThreadJobs.push_back(std::move(work));
+}
+
+size_t JobSystem::drainMainThreadQueue() {
+    std::vector<JobFunction> pending;
+    {
+        std::lock_guard<std::mutex> lock(mainThreadMutex);
+        pending.swap(mainThreadJobs);
+    }
+    for (auto& work : pending) {
+        work();
+    }
+    return pending.size();
+}
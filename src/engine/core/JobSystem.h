@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Reference to a scheduled job. Copyable; an empty handle counts as finished.
+class JobHandle {
+public:
+    JobHandle() = default;
+    bool isValid() const { return job != nullptr; }
+    bool isDone() const;
+
+private:
+    friend class JobSystem;
+    struct Job;
+    explicit JobHandle(std::shared_ptr<Job> job) : job(std::move(job)) {}
+    std::shared_ptr<Job> job;
+};
+
+// Work-stealing thread pool. Each worker owns a deque: it pushes and pops at the
+// back, idle workers steal from the front of the others. Jobs may depend on other
+// jobs and only become runnable once all of them have finished.
+//
+// SDL rendering calls aren't thread-safe, so anything touching the renderer goes
+// through runOnMainThread() and is executed when the engine drains that queue.
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+
+    // workerCount 0 picks hardware_concurrency - 1 (the main thread is the last core).
+    explicit JobSystem(unsigned int workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    JobHandle schedule(JobFunction work);
+    JobHandle schedule(JobFunction work, std::initializer_list<JobHandle> dependencies);
+    JobHandle schedule(JobFunction work, const std::vector<JobHandle>& dependencies);
+    // Continuation: runs after `job` has finished.
+    JobHandle then(const JobHandle& job, JobFunction work) { return schedule(std::move(work), { job }); }
+
+    // Blocks until the job is done, running other jobs (and, on the main thread,
+    // main-thread work) in the meantime so waiting never deadlocks the pool.
+    void wait(const JobHandle& job);
+    void waitAll(const std::vector<JobHandle>& jobs);
+
+    // Calls body(i) for every i in [begin, end), split into chunks of `grain`.
+    // Ranges that fit in one chunk run inline on the calling thread.
+    template <typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F&& body) {
+        if (end <= begin) return;
+        if (grain == 0) grain = 1;
+        if (end - begin <= grain || workers.empty()) {
+            for (size_t i = begin; i < end; i++) body(i);
+            return;
+        }
+
+        std::vector<JobHandle> chunks;
+        chunks.reserve((end - begin) / grain + 1);
+        for (size_t chunkBegin = begin + grain; chunkBegin < end; chunkBegin += grain) {
+            size_t chunkEnd = std::min(chunkBegin + grain, end);
+            chunks.push_back(schedule([&body, chunkBegin, chunkEnd] {
+                for (size_t i = chunkBegin; i < chunkEnd; i++) body(i);
+            }));
+        }
+        for (size_t i = begin; i < begin + grain; i++) body(i);
+        waitAll(chunks);
+    }
+
+    void runOnMainThread(JobFunction work);
+    // Runs everything queued for the main thread; returns how many ran.
+    size_t drainMainThreadQueue();
+
+    bool isMainThread() const { return std::this_thread::get_id() == mainThreadId; }
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    using JobPtr = std::shared_ptr<JobHandle::Job>;
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<JobPtr> jobs;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::atomic<unsigned int> nextQueue{ 0 };
+    std::atomic<int> queuedJobs{ 0 };
+    std::atomic<bool> stopping{ false };
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+
+    std::mutex mainThreadMutex;
+    std::vector<JobFunction> mainThreadJobs;
+    std::thread::id mainThreadId;
+
+    void workerLoop(unsigned int index);
+    void enqueue(JobPtr job);
+    JobPtr popLocal(unsigned int index);
+    JobPtr steal(unsigned int thiefIndex);
+    bool runOneJob();
+    void execute(const JobPtr& job);
+    void addDependency(const JobPtr& job, const JobHandle& dependency);
+    void releaseDependency(const JobPtr& job);
+};
@@ -1,7 +1,15 @@
 #include "SDLManager.h"
 #include <iostream>
 
-bool SDLManager::initialize(int width, int height, const char* title) {
+bool SDLManager::initialize(int width, int height, const char* title, bool headless) {
+    this->headless = headless;
+    if (headless) {
+        // No display or sound card on build boxes: the dummy drivers give us a
+        // window-less framebuffer and an audio device that just discards samples.
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
@@ -18,22 +26,41 @@ bool SDLManager::initialize(int width, int height, const char* title) {
     }
 
     window = SDL_CreateWindow(title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 
-                            width, height, SDL_WINDOW_SHOWN);
+                            width, height, headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
     if (!window) {
         std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    Uint32 rendererFlags = headless ? SDL_RENDERER_SOFTWARE : (SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
     if (!renderer) {
         std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
 
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    vsync = !headless;
     return true;
 }
 
+bool SDLManager::setVSync(bool enabled) {
+    if (!renderer) return false;
+    if (SDL_RenderSetVSync(renderer, enabled ? 1 : 0) != 0) {
+        Log::getInstance().warning("Could not change vsync: " + std::string(SDL_GetError()));
+        return false;
+    }
+    vsync = enabled;
+    return true;
+}
+
+int SDLManager::getRefreshRate() const {
+    if (!window) return 0;
+    SDL_DisplayMode mode;
+    if (SDL_GetWindowDisplayMode(window, &mode) != 0) return 0;
+    return mode.refresh_rate;
+}
+
 void SDLManager::shutdown() {
     if (renderer) {
         SDL_DestroyRenderer(renderer);
@@ -12,11 +12,17 @@ public:
         return instance;
     }
 
-    bool initialize(int width, int height, const char* title);
+    bool initialize(int width, int height, const char* title, bool headless = false);
     void shutdown();
     
     SDL_Window* getWindow() const { return window; }
     SDL_Renderer* getRenderer() const { return renderer; }
+    bool isHeadless() const { return headless; }
+
+    bool setVSync(bool enabled);
+    bool isVSync() const { return vsync; }
+    // Refresh rate of the display the window is on, 0 if unknown.
+    int getRefreshRate() const;
     
     void clear();
     void present();
@@ -25,11 +31,13 @@ public:
     void resetColor();
 
 private:
-    SDLManager() : window(nullptr), renderer(nullptr) {}
+    SDLManager() : window(nullptr), renderer(nullptr), headless(false) {}
     ~SDLManager();
     SDLManager(const SDLManager&) = delete;
     SDLManager& operator=(const SDLManager&) = delete;
 
     SDL_Window* window;
     SDL_Renderer* renderer;
+    bool headless;
+    bool vsync = false;
 }; 
\ No newline at end of file
@@ -1,14 +1,28 @@
 #pragma once
 #include <vector>
+#include "../utils/MemoryArena.h"
 
 class SubState;
+struct AssetManifest;
 
 class State {
 public:
     virtual ~State() {}
+
+    // Loading stage, before create(). Engine::transitionTo decodes the manifest and
+    // then runs preload() on worker threads while the previous state keeps running,
+    // so preload() must not touch the renderer, the engine's sprite lists or
+    // anything the running state reads. pushState/switchState run it inline.
+    virtual void declareAssets(AssetManifest&) {}
+    virtual void preload() {}
+
     virtual void create() = 0;
     virtual void update(float deltaTime) = 0;
     virtual void render() = 0;
+    // What the engine calls each frame. The argument is how far the clock is
+    // between the last two fixed updates (0..1); states that don't interpolate
+    // keep this default.
+    virtual void renderInterpolated(float) { render(); }
     virtual void destroy() = 0;
 
     virtual void openSubState(SubState* subState);
@@ -18,6 +32,15 @@ public:
     virtual void keyPressed(unsigned char key) {}
     virtual void specialKeyPressed(int key, int x, int y) {}
 
+    const MemoryArena& getArena() const { return arena; }
+
 protected:
     std::vector<SubState*> _subStates;
+    // Backing store for objects that live exactly as long as the state. Torn down
+    // after the derived destructor has run.
+    MemoryArena arena;
+
+private:
+    friend class Engine;
+    bool preloaded = false;
 };
@@ -0,0 +1,145 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel() {
+    for (uint32_t& head : slots) {
+        head = NONE;
+    }
+}
+
+uint32_t TimerWheel::allocateNode() {
+    if (!freeNodes.empty()) {
+        uint32_t index = freeNodes.back();
+        freeNodes.pop_back();
+        return index;
+    }
+    nodes.emplace_back();
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void TimerWheel::releaseNode(uint32_t index) {
+    Node& node = nodes[index];
+    node.callback.reset();
+    node.generation++;
+    freeNodes.push_back(index);
+}
+
+void TimerWheel::link(uint32_t index) {
+    Node& node = nodes[index];
+
+    uint64_t maxDelta = (uint64_t(1) << (LEVELS * SLOT_BITS)) - 1;
+    if (node.expires - currentTick > maxDelta) {
+        node.expires = currentTick + maxDelta;
+    }
+
+    uint64_t delta = node.expires - currentTick;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << ((level + 1) * SLOT_BITS))) {
+        level++;
+    }
+
+    uint32_t slot = level * SLOTS + static_cast<uint32_t>((node.expires >> (level * SLOT_BITS)) & SLOT_MASK);
+    node.slot = slot;
+    node.prev = NONE;
+    node.next = slots[slot];
+    if (node.next != NONE) {
+        nodes[node.next].prev = index;
+    }
+    slots[slot] = index;
+    pendingCount++;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes[index];
+    if (node.prev != NONE) {
+        nodes[node.prev].next = node.next;
+    } else {
+        slots[node.slot] = node.next;
+    }
+    if (node.next != NONE) {
+        nodes[node.next].prev = node.prev;
+    }
+    node.prev = NONE;
+    node.next = NONE;
+    node.slot = NONE;
+    pendingCount--;
+}
+
+bool TimerWheel::isPending(TimerHandle handle) const {
+    return handle.index < nodes.size() &&
+           nodes[handle.index].generation == handle.generation &&
+           nodes[handle.index].slot != NONE;
+}
+
+bool TimerWheel::cancel(TimerHandle handle) {
+    if (!isPending(handle)) return false;
+    unlink(handle.index);
+    releaseNode(handle.index);
+    return true;
+}
+
+void TimerWheel::cascade(int level, uint32_t slotIndex) {
+    uint32_t slot = level * SLOTS + slotIndex;
+    uint32_t index = slots[slot];
+    while (index != NONE) {
+        uint32_t next = nodes[index].next;
+        unlink(index);
+        link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::expireSlot(uint32_t slot) {
+    // Re-read the head each time: a callback may cancel or add timers in this slot.
+    while (slots[slot] != NONE) {
+        uint32_t index = slots[slot];
+        unlink(index);
+        // Move out before invoking, the callback may schedule and grow the node pool.
+        Callback callback = std::move(nodes[index].callback);
+        releaseNode(index);
+        callback();
+    }
+}
+
+void TimerWheel::advance(uint64_t ticks) {
+    if (pendingCount == 0) {
+        currentTick += ticks;
+        return;
+    }
+
+    for (uint64_t i = 0; i < ticks; i++) {
+        currentTick++;
+
+        uint32_t index = static_cast<uint32_t>(currentTick & SLOT_MASK);
+        if (index == 0) {
+            for (int level = 1; level < LEVELS; level++) {
+                uint32_t levelIndex = static_cast<uint32_t>((currentTick >> (level * SLOT_BITS)) & SLOT_MASK);
+                cascade(level, levelIndex);
+                if (levelIndex != 0) break;
+            }
+        }
+
+        expireSlot(index);
+
+        if (pendingCount == 0) {
+            currentTick += ticks - i - 1;
+            return;
+        }
+    }
+}
+
+void TimerWheel::reset() {
+    for (uint32_t& head : slots) {
+        uint32_t index = head;
+        while (index != NONE) {
+            uint32_t next = nodes[index].next;
+            nodes[index].prev = NONE;
+            nodes[index].next = NONE;
+            nodes[index].slot = NONE;
+            releaseNode(index);
+            index = next;
+        }
+        head = NONE;
+    }
+    pendingCount = 0;
+    currentTick = 0;
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// void() callable stored in a fixed buffer. Never allocates; a capture list that
+// doesn't fit is a compile error rather than a silent heap fallback.
+template <size_t Capacity>
+class InlineCallback {
+public:
+    InlineCallback() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineCallback>>>
+    InlineCallback(F&& f) { assign(std::forward<F>(f)); }
+
+    InlineCallback(InlineCallback&& other) noexcept { moveFrom(other); }
+    InlineCallback& operator=(InlineCallback&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+    InlineCallback(const InlineCallback&) = delete;
+    InlineCallback& operator=(const InlineCallback&) = delete;
+    ~InlineCallback() { reset(); }
+
+    template <typename F>
+    void assign(F&& f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity, "callback captures too much to be stored inline");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "callback is over-aligned");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>, "callback must be nothrow movable");
+        reset();
+        new (storage) Fn(std::forward<F>(f));
+        ops = &opsFor<Fn>;
+    }
+
+    void operator()() { ops->invoke(storage); }
+    explicit operator bool() const { return ops != nullptr; }
+
+    void reset() {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void*);
+    };
+
+    template <typename Fn>
+    static constexpr Ops opsFor = {
+        [](void* p) { (*static_cast<Fn*>(p))(); },
+        [](void* dst, void* src) { new (dst) Fn(std::move(*static_cast<Fn*>(src))); },
+        [](void* p) { static_cast<Fn*>(p)->~Fn(); }
+    };
+
+    void moveFrom(InlineCallback& other) {
+        if (other.ops) {
+            other.ops->move(storage, other.storage);
+            ops = other.ops;
+            other.reset();
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const Ops* ops = nullptr;
+};
+
+struct TimerHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != UINT32_MAX; }
+};
+
+// Hierarchical timing wheel (4 levels x 256 slots). Ticks are whatever unit the
+// owner advances it in: milliseconds for Engine timeouts, steps for Conductor.
+// Insert, cancel and per-tick expiry are all O(1); far timers cascade down a
+// level each time the level below wraps.
+class TimerWheel {
+public:
+    static constexpr size_t CALLBACK_SIZE = 48;
+    using Callback = InlineCallback<CALLBACK_SIZE>;
+
+    TimerWheel();
+
+    template <typename F>
+    TimerHandle schedule(uint64_t delayTicks, F&& callback) {
+        return scheduleAt(currentTick + (delayTicks > 0 ? delayTicks : 1), std::forward<F>(callback));
+    }
+
+    // Ticks at or before the current one fire on the next advance.
+    template <typename F>
+    TimerHandle scheduleAt(uint64_t tick, F&& callback) {
+        uint32_t index = allocateNode();
+        Node& node = nodes[index];
+        node.callback.assign(std::forward<F>(callback));
+        node.expires = tick > currentTick ? tick : currentTick + 1;
+        link(index);
+        return TimerHandle{ index, node.generation };
+    }
+
+    bool cancel(TimerHandle handle);
+    bool isPending(TimerHandle handle) const;
+
+    void advance(uint64_t ticks);
+    void advanceTo(uint64_t tick) {
+        if (tick > currentTick) advance(tick - currentTick);
+    }
+
+    // Drops every pending timer and rewinds the wheel to tick 0.
+    void reset();
+
+    uint64_t getCurrentTick() const { return currentTick; }
+    size_t getPendingCount() const { return pendingCount; }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        Callback callback;
+        uint64_t expires = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        uint32_t slot = NONE;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+    uint32_t slots[LEVELS * SLOTS];
+    uint64_t currentTick = 0;
+    size_t pendingCount = 0;
+
+    uint32_t allocateNode();
+    void releaseNode(uint32_t index);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void cascade(int level, uint32_t slotIndex);
+    void expireSlot(uint32_t slot);
+};
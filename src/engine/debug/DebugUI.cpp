@@ -1,5 +1,6 @@
 #include "DebugUI.h"
 #include "../core/Engine.h"
+#include "../graphics/Renderer.h"
 #include <sstream>
 #include <iomanip>
 
@@ -12,38 +13,67 @@ DebugUI::DebugUI() {
     fpsText = new Text(10, 10, 500);
     ramText = new Text(10, 30, 500);
     memoryText = new Text(10, 50, 500);
+    drawText = new Text(10, 70, 500);
     fpsText->setText("FPS: 0");
     ramText->setText("RAM: 0 MB");
     memoryText->setText("Memory: 0 MB");
+    drawText->setText("Draws: 0");
     fpsText->setFormat("assets/fonts/5by7.ttf", 14, 0xFFFFFFFF);
     ramText->setFormat("assets/fonts/5by7.ttf", 14, 0xFFFFFFFF);
     memoryText->setFormat("assets/fonts/5by7.ttf", 14, 0xFFFFFFFF);
+    drawText->setFormat("assets/fonts/5by7.ttf", 14, 0xFFFFFFFF);
     
     fpsUpdateTimer = 0.0f;
     currentFPS = 0.0f;
+    framesRendered = 0;
 }
 
 DebugUI::~DebugUI() {
     delete fpsText;
     delete ramText;
     delete memoryText;
+    delete drawText;
 }
 
 void DebugUI::update(float deltaTime) {
     updateFPS(deltaTime);
     updateMemoryStats();
+    updateDrawStats();
 }
 
 void DebugUI::render() {
+    framesRendered++;
     fpsText->render();
     ramText->render();
     memoryText->render();
+    drawText->render();
+}
+
+void DebugUI::updateDrawStats() {
+    Renderer& renderer = Renderer::getInstance();
+    int drawCalls = renderer.getDrawCalls();
+    int spriteCount = renderer.getSpriteCount();
+    int culledCount = renderer.getCulledCount();
+    int stateChanges = renderer.getStateChanges();
+    if (drawCalls == shownDrawCalls && spriteCount == shownSpriteCount && culledCount == shownCulledCount &&
+        stateChanges == shownStateChanges) return;
+
+    shownDrawCalls = drawCalls;
+    shownSpriteCount = spriteCount;
+    shownCulledCount = culledCount;
+    shownStateChanges = stateChanges;
+    drawText->setText("Draws: " + std::to_string(drawCalls) + " (" + std::to_string(spriteCount) +
+                      " sprites, " + std::to_string(culledCount) + " culled), state changes: " +
+                      std::to_string(stateChanges));
 }
 
 void DebugUI::updateFPS(float deltaTime) {
     fpsUpdateTimer += deltaTime;
     if (fpsUpdateTimer >= FPS_UPDATE_INTERVAL) {
-        currentFPS = 1.0f / deltaTime;
+        // Count presented frames rather than inverting deltaTime, which is the
+        // simulation step and stays constant under a fixed timestep.
+        currentFPS = framesRendered / fpsUpdateTimer;
+        framesRendered = 0;
         std::stringstream ss;
         ss << "FPS: " << std::fixed << std::setprecision(1) << currentFPS;
         fpsText->setText(ss.str());
@@ -24,13 +24,20 @@ private:
     Text* fpsText;
     Text* ramText;
     Text* memoryText;
+    Text* drawText;
     
     float fpsUpdateTimer;
     static constexpr float FPS_UPDATE_INTERVAL = 0.5f;
     float currentFPS;
+    int framesRendered;
+    int shownDrawCalls = -1;
+    int shownSpriteCount = -1;
+    int shownCulledCount = -1;
+    int shownStateChanges = -1;
     
     void updateFPS(float deltaTime);
     void updateMemoryStats();
+    void updateDrawStats();
     
 #ifdef _WIN32
     void updateMemoryStatsWindows();
@@ -1,9 +1,14 @@
 #include "AnimatedSprite.h"
+#include "Camera.h"
 #include "../core/SDLManager.h"
+#include "../core/AssetCache.h"
+#include "TextureImporter.h"
+#include "MipChain.h"
+#include "AtlasCache.h"
+#include "../utils/MappedFile.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <cmath>
 
 AnimatedSprite::AnimatedSprite() : Sprite() {}
 
@@ -37,30 +42,37 @@ void AnimatedSprite::update(float deltaTime) {
 }
 
 void AnimatedSprite::render() {
-    if (!visible || !currentAnimation || currentAnimation->frames.empty()) {
+    if (!visible || !currentAnimation || currentAnimation->records.empty()) {
         //if (!currentAnimation) Log::getInstance().error("No current animation");
-        if (currentAnimation && currentAnimation->frames.empty()) Log::getInstance().error("No frames in animation");
+        if (currentAnimation && currentAnimation->records.empty()) Log::getInstance().error("No frames in animation");
         return;
     }
 
-    const Frame& frame = currentAnimation->frames[currentFrame];
-    
-    SDL_Rect srcRect = {
-        frame.x,
-        frame.y,
-        frame.width,
-        frame.height
-    };
-
-    SDL_Rect destRect = {
-        static_cast<int>(x + offsetX),
-        static_cast<int>(y + offsetY),
-        static_cast<int>(frame.width * scale.x),
-        static_cast<int>(frame.height * scale.y)
-    };
-
-    SDL_RendererFlip flip = scale.x < 0 ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-    SDL_RenderCopyEx(SDLManager::getInstance().getRenderer(), texture, &srcRect, &destRect, 0, nullptr, flip);
+    // With a negative scale.x the record mirrors about x, so the whole untrimmed
+    // frame flips, not just the packed region.
+    const DrawRecord& record = currentAnimation->records[currentFrame];
+    SDL_FRect destRect = { x + offsetX + record.offsetX * scale.x, y + offsetY + record.offsetY * scale.y,
+                           record.width * scale.x, record.height * scale.y };
+    if (!Camera::isOnScreen(destRect)) {
+        Renderer::getInstance().countCulled();
+        return;
+    }
+
+    SDL_Rect srcRect = record.source;
+    SDL_RendererFlip flip = static_cast<SDL_RendererFlip>(std::signbit(scale.x) * SDL_FLIP_HORIZONTAL);
+    SDL_Texture* source = selectMip(std::min(std::fabs(scale.x), std::fabs(scale.y)), &srcRect);
+    Renderer::getInstance().drawTexture(source, &srcRect, destRect, alpha, flip);
+}
+
+AnimatedSprite::DrawRecord AnimatedSprite::DrawRecord::bake(const Frame& frame) {
+    // Sparrow stores the trim as the negated position of the region in the frame.
+    DrawRecord record;
+    record.source = { frame.x, frame.y, frame.width, frame.height };
+    record.offsetX = static_cast<float>(-frame.frameX);
+    record.offsetY = static_cast<float>(-frame.frameY);
+    record.width = static_cast<float>(frame.width);
+    record.height = static_cast<float>(frame.height);
+    return record;
 }
 
 void AnimatedSprite::loadTexture(const std::string& imagePath) {
@@ -71,18 +83,21 @@ void AnimatedSprite::loadTexture(const std::string& imagePath) {
 
     Log::getInstance().info("Attempting to load image from: " + imagePath);
     
-    SDL_Surface* surface = IMG_Load(imagePath.c_str());
+    bool ownsSurface = false;
+    SDL_Surface* surface = TextureImporter::load(imagePath, ownsSurface);
     if (!surface) {
-        Log::getInstance().error("Failed to load image: " + imagePath);
-        Log::getInstance().error("SDL_image error: " + std::string(IMG_GetError()));
         return;
     }
 
     width = surface->w;
     height = surface->h;
 
-    texture = SDL_CreateTextureFromSurface(SDLManager::getInstance().getRenderer(), surface);
-    SDL_FreeSurface(surface);
+    texture = Renderer::getInstance().createTexture(surface);
+    ownsTexture = true;
+    mips = MipChain::build(surface);
+    if (ownsSurface) {
+        SDL_FreeSurface(surface);
+    }
 
     if (!texture) {
         Log::getInstance().error("Failed to create texture from surface: " + std::string(SDL_GetError()));
@@ -103,55 +118,155 @@ void AnimatedSprite::loadFrames(const std::string& imagePath, const std::string&
 }
 
 void AnimatedSprite::parseXML(const std::string& xmlPath) {
+    if (AtlasCache::load(xmlPath, frames)) {
+        Log::getInstance().info("Loaded cached atlas for " + xmlPath);
+        return;
+    }
+
     Log::getInstance().info("Attempting to parse XML file: " + xmlPath);
-    std::ifstream file(xmlPath);
-    if (!file.is_open()) {
+    std::string preloaded;
+    MappedFile file;
+    std::string_view xml;
+    if (AssetCache::getInstance().getText(xmlPath, preloaded)) {
+        xml = preloaded;
+    } else if (file.open(xmlPath)) {
+        xml = file.view();
+    } else {
         Log::getInstance().error("Failed to open XML file: " + xmlPath);
         return;
     }
 
-    std::string line;
-    int frameCount = 0;
-    while (std::getline(file, line)) {
-        if (line.find("<SubTexture") != std::string::npos) {
-            Frame frame;
-            size_t nameStart = line.find("name=\"") + 6;
-            size_t nameEnd = line.find("\"", nameStart);
-            frame.name = line.substr(nameStart, nameEnd - nameStart);
-
-            std::istringstream iss(line);
-            std::string token;
-            while (std::getline(iss, token, ' ')) {
-                size_t pos = token.find('=');
-                if (pos != std::string::npos) {
-                    std::string key = token.substr(0, pos);
-                    std::string value = token.substr(pos + 2, token.length() - pos - 3);
-                    if (key == "x") frame.x = std::stoi(value);
-                    else if (key == "y") frame.y = std::stoi(value);
-                    else if (key == "width") frame.width = std::stoi(value);
-                    else if (key == "height") frame.height = std::stoi(value);
-                    else if (key == "frameX") frame.frameX = std::stoi(value);
-                    else if (key == "frameY") frame.frameY = std::stoi(value);
-                    else if (key == "frameWidth") frame.frameWidth = std::stoi(value);
-                    else if (key == "frameHeight") frame.frameHeight = std::stoi(value);
+    if (!parseSparrow(xml, frames)) {
+        Log::getInstance().warning("No frames in XML file: " + xmlPath);
+        return;
+    }
+    AtlasCache::saveMiss(xmlPath, frames);
+}
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    // Some exporters write "12.0"; the fraction is dropped, as stoi did.
+    int parseInt(std::string_view text) {
+        size_t i = 0;
+        bool negative = false;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+            negative = text[i] == '-';
+            i++;
+        }
+        int value = 0;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++) {
+            value = value * 10 + (text[i] - '0');
+        }
+        return negative ? -value : value;
+    }
+
+    std::string decodeName(std::string_view text) {
+        if (text.find('&') == std::string_view::npos) {
+            return std::string(text);
+        }
+        static const std::pair<std::string_view, char> entities[] = {
+            { "&amp;", '&' }, { "&quot;", '"' }, { "&apos;", '\'' }, { "&lt;", '<' }, { "&gt;", '>' }
+        };
+        std::string result;
+        result.reserve(text.size());
+        for (size_t i = 0; i < text.size();) {
+            bool replaced = false;
+            if (text[i] == '&') {
+                for (const auto& entity : entities) {
+                    if (text.substr(i, entity.first.size()) == entity.first) {
+                        result += entity.second;
+                        i += entity.first.size();
+                        replaced = true;
+                        break;
+                    }
                 }
             }
-            frames[frame.name] = frame;
-            frameCount++;
+            if (!replaced) {
+                result += text[i++];
+            }
         }
+        return result;
     }
 }
 
+bool AnimatedSprite::parseSparrow(std::string_view xml, std::vector<Frame>& frames) {
+    constexpr std::string_view tag = "<SubTexture";
+    frames.clear();
+
+    // Attributes are read in place, wherever the tag's line breaks fall.
+    size_t pos = 0;
+    while ((pos = xml.find(tag, pos)) != std::string_view::npos) {
+        pos += tag.size();
+        Frame frame;
+        while (pos < xml.size()) {
+            while (pos < xml.size() && isSpace(xml[pos])) pos++;
+            if (pos >= xml.size() || xml[pos] == '/' || xml[pos] == '>') break;
+
+            size_t keyStart = pos;
+            while (pos < xml.size() && xml[pos] != '=' && xml[pos] != '>' && xml[pos] != '/' && !isSpace(xml[pos])) pos++;
+            std::string_view key = xml.substr(keyStart, pos - keyStart);
+            while (pos < xml.size() && isSpace(xml[pos])) pos++;
+            if (pos >= xml.size() || xml[pos] != '=') {
+                if (key.empty()) pos++;
+                continue;
+            }
+            pos++;
+            while (pos < xml.size() && isSpace(xml[pos])) pos++;
+            if (pos >= xml.size() || (xml[pos] != '"' && xml[pos] != '\'')) continue;
+
+            char quote = xml[pos++];
+            size_t valueEnd = xml.find(quote, pos);
+            if (valueEnd == std::string_view::npos) {
+                pos = xml.size();
+                break;
+            }
+            std::string_view value = xml.substr(pos, valueEnd - pos);
+            pos = valueEnd + 1;
+
+            if (key == "name") frame.name = decodeName(value);
+            else if (key == "x") frame.x = parseInt(value);
+            else if (key == "y") frame.y = parseInt(value);
+            else if (key == "width") frame.width = parseInt(value);
+            else if (key == "height") frame.height = parseInt(value);
+            else if (key == "frameX") frame.frameX = parseInt(value);
+            else if (key == "frameY") frame.frameY = parseInt(value);
+            else if (key == "frameWidth") frame.frameWidth = parseInt(value);
+            else if (key == "frameHeight") frame.frameHeight = parseInt(value);
+        }
+        frames.push_back(std::move(frame));
+    }
+
+    std::stable_sort(frames.begin(), frames.end(),
+        [](const Frame& a, const Frame& b) { return a.name < b.name; });
+    size_t kept = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (i + 1 < frames.size() && frames[i + 1].name == frames[i].name) continue;
+        if (kept != i) frames[kept] = std::move(frames[i]);
+        kept++;
+    }
+    frames.resize(kept);
+    return !frames.empty();
+}
+
+const AnimatedSprite::Frame* AnimatedSprite::findFrame(std::string_view name) const {
+    auto it = std::lower_bound(frames.begin(), frames.end(), name,
+        [](const Frame& frame, std::string_view key) { return frame.name < key; });
+    return it != frames.end() && it->name == name ? &*it : nullptr;
+}
+
 void AnimatedSprite::addAnimation(const std::string& name, const std::string& prefix, int fps, bool loop) {
     Animation animation;
     animation.name = name;
     animation.frameRate = fps;
     animation.loop = loop;
 
-    for (const auto& pair : frames) {
-        if (pair.first.find(prefix) == 0) {
-            animation.addFrame(pair.second);
-        }
+    auto it = std::lower_bound(frames.begin(), frames.end(), prefix,
+        [](const Frame& frame, const std::string& key) { return frame.name < key; });
+    for (; it != frames.end() && it->name.compare(0, prefix.size(), prefix) == 0; ++it) {
+        animation.addFrame(*it);
     }
 
     animations[name] = animation;
@@ -165,9 +280,8 @@ void AnimatedSprite::addAnimation(const std::string& name, const std::string& pr
     animation.loop = loop;
 
     for (int index : indices) {
-        std::string frameName = prefix + " " + std::to_string(index);
-        if (frames.find(frameName) != frames.end()) {
-            animation.addFrame(frames[frameName]);
+        if (const Frame* frame = findFrame(prefix + " " + std::to_string(index))) {
+            animation.addFrame(*frame);
         }
     }
 
@@ -181,8 +295,8 @@ void AnimatedSprite::addAnimation(const std::string& name, const std::vector<std
     animation.loop = loop;
 
     for (const auto& frameName : frameNames) {
-        if (frames.find(frameName) != frames.end()) {
-            animation.addFrame(frames[frameName]);
+        if (const Frame* frame = findFrame(frameName)) {
+            animation.addFrame(*frame);
         }
     }
 
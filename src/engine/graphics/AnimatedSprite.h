@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <iostream>
@@ -10,17 +11,34 @@ class AnimatedSprite : public Sprite {
 public:
     struct Frame {
         std::string name;
-        int x, y, width, height;
-        int frameX, frameY, frameWidth, frameHeight;
+        int x = 0, y = 0, width = 0, height = 0;
+        // Trim: where the packed region sits inside the original, untrimmed frame.
+        // Atlases that don't trim leave these out.
+        int frameX = 0, frameY = 0, frameWidth = 0, frameHeight = 0;
+    };
+
+    // A frame as render() uses it: the atlas region and where it goes relative
+    // to the sprite's origin, in texels before scaling.
+    struct DrawRecord {
+        SDL_Rect source;
+        float offsetX, offsetY;
+        float width, height;
+
+        static DrawRecord bake(const Frame& frame);
     };
 
     struct Animation {
         std::string name;
         std::vector<Frame> frames;
+        // One per frame, in the same order.
+        std::vector<DrawRecord> records;
         int frameRate;
         bool loop;
 
-        void addFrame(const Frame& frame) { frames.push_back(frame); }
+        void addFrame(const Frame& frame) {
+            frames.push_back(frame);
+            records.push_back(DrawRecord::bake(frame));
+        }
     };
 
     AnimatedSprite();
@@ -65,7 +83,7 @@ public:
     }
 
     float alpha = 1.0f;
-    void updateHitbox() {
+    void updateHitbox() override {
         if (currentAnimation && !currentAnimation->frames.empty()) {
             const Frame& frame = currentAnimation->frames[currentFrame];
             width = frame.width;
@@ -87,11 +105,17 @@ public:
 
     SDL_Texture* shareTexture() const { return texture; }
     
-    const std::map<std::string, Frame>& getFrames() const { return frames; }
+    // Sorted by name, so every animation prefix is one contiguous run.
+    const std::vector<Frame>& getFrames() const { return frames; }
+    const Frame* findFrame(std::string_view name) const;
     void copyFramesFrom(const AnimatedSprite& other) { frames = other.getFrames(); }
 
+    // Frames of every SubTexture in a Sparrow atlas, sorted by name (a repeated
+    // name keeps its last entry). False when the document has none.
+    static bool parseSparrow(std::string_view xml, std::vector<Frame>& frames);
+
 protected:
-    std::map<std::string, Frame> frames;
+    std::vector<Frame> frames;
     float offsetX = 0;
     float offsetY = 0;
 
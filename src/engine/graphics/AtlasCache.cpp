@@ -0,0 +1,213 @@
+#include "AtlasCache.h"
+#include "../utils/Log.h"
+#include "../utils/MappedFile.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+std::string AtlasCache::directory = "cache/atlases";
+std::atomic<bool> AtlasCache::saveOnMiss{ false };
+std::atomic<int> AtlasCache::directoryState{ 0 };
+
+namespace {
+    constexpr uint32_t MAGIC = 0x41464E46; // "FNFA" read as little-endian
+    constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint32_t frameCount;
+        uint32_t namesSize;
+    };
+
+    struct FrameEntry {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        int32_t x, y, width, height;
+        int32_t frameX, frameY, frameWidth, frameHeight;
+    };
+
+    bool getSourceStamp(const std::string& xmlPath, uint64_t& size, int64_t& time) {
+        std::error_code error;
+        size = std::filesystem::file_size(xmlPath, error);
+        if (error) return false;
+        auto written = std::filesystem::last_write_time(xmlPath, error);
+        if (error) return false;
+        time = static_cast<int64_t>(written.time_since_epoch().count());
+        return true;
+    }
+}
+
+void AtlasCache::setDirectory(const std::string& path) {
+    directory = path;
+    directoryState = 0;
+}
+
+bool AtlasCache::createDirectory() {
+    int state = directoryState.load();
+    if (state != 0) return state > 0;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    bool created = !error;
+    if (!created) {
+        Log::getInstance().warning("Could not create atlas cache directory: " + directory + " (" + error.message() + ")");
+    }
+    directoryState = created ? 1 : -1;
+    return created;
+}
+
+void AtlasCache::setSaveOnMiss(bool enabled) {
+#ifdef __SWITCH__
+    enabled = false;
+#endif
+    saveOnMiss = enabled;
+}
+
+void AtlasCache::saveMiss(const std::string& xmlPath, const std::vector<AnimatedSprite::Frame>& frames) {
+    if (!saveOnMiss.load()) return;
+    if (!save(xmlPath, frames) && saveOnMiss.exchange(false)) {
+        Log::getInstance().warning("Atlas cache writes disabled after a failure");
+    }
+}
+
+std::string AtlasCache::getCachePath(const std::string& xmlPath) {
+    std::string name = xmlPath;
+    for (char& c : name) {
+        if (c == '/' || c == '\\' || c == ':') c = '_';
+    }
+    return directory + "/" + name + ".atlas";
+}
+
+bool AtlasCache::load(const std::string& xmlPath, std::vector<AnimatedSprite::Frame>& frames) {
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    std::error_code error;
+    std::string cachePath = getCachePath(xmlPath);
+    if (!getSourceStamp(xmlPath, sourceSize, sourceTime) || !std::filesystem::exists(cachePath, error)) {
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.open(cachePath) || file.size() < sizeof(Header)) return false;
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.sourceSize != sourceSize || header.sourceTime != sourceTime) {
+        return false;
+    }
+    size_t tableSize = static_cast<size_t>(header.frameCount) * sizeof(FrameEntry);
+    if (file.size() != sizeof(Header) + tableSize + header.namesSize) {
+        Log::getInstance().warning("Ignoring truncated atlas cache: " + cachePath);
+        return false;
+    }
+
+    const char* table = file.data() + sizeof(Header);
+    const char* names = table + tableSize;
+    frames.clear();
+    frames.resize(header.frameCount);
+    for (uint32_t i = 0; i < header.frameCount; i++) {
+        FrameEntry entry;
+        std::memcpy(&entry, table + i * sizeof(FrameEntry), sizeof(FrameEntry));
+        if (entry.nameOffset > header.namesSize || entry.nameLength > header.namesSize - entry.nameOffset) {
+            Log::getInstance().warning("Ignoring corrupt atlas cache: " + cachePath);
+            frames.clear();
+            return false;
+        }
+        AnimatedSprite::Frame& frame = frames[i];
+        frame.name.assign(names + entry.nameOffset, entry.nameLength);
+        frame.x = entry.x;
+        frame.y = entry.y;
+        frame.width = entry.width;
+        frame.height = entry.height;
+        frame.frameX = entry.frameX;
+        frame.frameY = entry.frameY;
+        frame.frameWidth = entry.frameWidth;
+        frame.frameHeight = entry.frameHeight;
+    }
+    return true;
+}
+
+bool AtlasCache::save(const std::string& xmlPath, const std::vector<AnimatedSprite::Frame>& frames) {
+    Header header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    if (!getSourceStamp(xmlPath, header.sourceSize, header.sourceTime)) {
+        return false;
+    }
+
+    std::vector<FrameEntry> table(frames.size());
+    std::string names;
+    for (size_t i = 0; i < frames.size(); i++) {
+        const AnimatedSprite::Frame& frame = frames[i];
+        table[i] = { static_cast<uint32_t>(names.size()), static_cast<uint32_t>(frame.name.size()),
+                     frame.x, frame.y, frame.width, frame.height,
+                     frame.frameX, frame.frameY, frame.frameWidth, frame.frameHeight };
+        names += frame.name;
+    }
+    header.frameCount = static_cast<uint32_t>(table.size());
+    header.namesSize = static_cast<uint32_t>(names.size());
+
+    if (!createDirectory()) return false;
+    std::string cachePath = getCachePath(xmlPath);
+    std::error_code error;
+
+    // Written aside and renamed into place, so a reader never maps half a file.
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            Log::getInstance().warning("Could not write atlas cache: " + cachePath);
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(FrameEntry)));
+        out.write(names.data(), static_cast<std::streamsize>(names.size()));
+        if (!out) {
+            Log::getInstance().warning("Could not write atlas cache: " + cachePath);
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        Log::getInstance().warning("Could not write atlas cache: " + cachePath + " (" + error.message() + ")");
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+int AtlasCache::bakeDirectory(const std::string& sourceDirectory) {
+    std::error_code error;
+    std::filesystem::directory_iterator it(sourceDirectory, error);
+    if (error) {
+        Log::getInstance().error("Could not open atlas directory: " + sourceDirectory);
+        return 0;
+    }
+    if (!createDirectory()) return 0;
+
+    int baked = 0;
+    for (const auto& entry : it) {
+        std::filesystem::path path = entry.path();
+        if (path.extension() != ".xml") continue;
+        std::filesystem::path image = path;
+        if (!std::filesystem::exists(image.replace_extension(".png"), error)) continue;
+
+        // Same spelling of the path the game uses, so it finds the cache file.
+        std::string xmlPath = path.generic_string();
+        MappedFile file;
+        std::vector<AnimatedSprite::Frame> frames;
+        if (!file.open(xmlPath) || !AnimatedSprite::parseSparrow(file.view(), frames)) continue;
+        if (save(xmlPath, frames)) {
+            baked++;
+        }
+    }
+    Log::getInstance().info("Baked " + std::to_string(baked) + " atlases from " + sourceDirectory);
+    return baked;
+}
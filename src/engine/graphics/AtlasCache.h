@@ -0,0 +1,42 @@
+#pragma once
+
+#include "AnimatedSprite.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Binary copies of parsed Sparrow atlases, so a state doesn't reparse the same
+// XML every time it loads. A cache file holds the sorted frame table and one
+// table of the names it references, and is mapped and read in a single pass.
+// It records the XML's size and modification time and is ignored once either
+// changes. Files are written by --bake-atlases, and on a cache miss only when
+// that has been switched on, since an install may be read-only.
+class AtlasCache {
+public:
+    // Where cache files go. Default "cache/atlases".
+    static void setDirectory(const std::string& path);
+    static std::string getCachePath(const std::string& xmlPath);
+
+    // Frames for xmlPath from its cache file, if one exists and is current.
+    static bool load(const std::string& xmlPath, std::vector<AnimatedSprite::Frame>& frames);
+    // Writes the cache file for frames parsed from xmlPath. Logs on failure.
+    static bool save(const std::string& xmlPath, const std::vector<AnimatedSprite::Frame>& frames);
+
+    // Whether atlases parsed on a cache miss are saved. Off by default, and
+    // always off on Switch. Turned off again after the first failed write.
+    static void setSaveOnMiss(bool enabled);
+    // Saves frames just parsed from xmlPath, if saving on a miss is on.
+    static void saveMiss(const std::string& xmlPath, const std::vector<AnimatedSprite::Frame>& frames);
+
+    // Parses and caches every .xml atlas in directory that has a matching .png.
+    // Returns how many were written.
+    static int bakeDirectory(const std::string& directory);
+
+private:
+    static std::string directory;
+    static std::atomic<bool> saveOnMiss;
+    // 0 not yet created, 1 created, -1 could not be created.
+    static std::atomic<int> directoryState;
+
+    static bool createDirectory();
+};
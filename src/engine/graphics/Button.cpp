@@ -1,5 +1,6 @@
 #include "Button.h"
 #include "../core/SDLManager.h"
+#include "Renderer.h"
 
 Button::Button(float x, float y, const std::string& text, std::function<void()> onClick)
     : Text(x, y), onClick(onClick), padding(10.0f), hovered(false), pressed(false) {
@@ -25,12 +26,11 @@ void Button::render() {
     };
 
     unsigned int currentColor = hovered ? hoverColor : backgroundColor;
-    SDL_SetRenderDrawColor(SDLManager::getInstance().getRenderer(),
+    Renderer::getInstance().fillRect(rect,
                           (currentColor >> 24) & 0xFF,
                           (currentColor >> 16) & 0xFF,
                           (currentColor >> 8) & 0xFF,
                           currentColor & 0xFF);
-    SDL_RenderFillRect(SDLManager::getInstance().getRenderer(), &rect);
 
     Text::render();
 }
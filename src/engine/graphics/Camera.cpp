@@ -1,27 +1,50 @@
 #include "Camera.h"
-#include "../core/SDLManager.h"
+#include "Renderer.h"
+#include "../core/Engine.h"
+
+static bool overlaps(const SDL_FRect& a, const SDL_FRect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Sizes can be negative for mirrored sprites.
+static SDL_FRect normalized(const SDL_FRect& rect) {
+    SDL_FRect result = rect;
+    if (result.w < 0) { result.x += result.w; result.w = -result.w; }
+    if (result.h < 0) { result.y += result.h; result.h = -result.h; }
+    return result;
+}
+
+static SDL_FRect screenBounds() {
+    Engine* engine = Engine::getInstance();
+    if (!engine) return { 0, 0, 0, 0 };
+    return { 0.0f, 0.0f, static_cast<float>(engine->getWindowWidth()), static_cast<float>(engine->getWindowHeight()) };
+}
 
 Camera::Camera() {}
 
 void Camera::begin() {
     if (!visible) return;
     
-    SDL_Renderer* renderer = SDLManager::getInstance().getRenderer();
-    SDL_RenderSetViewport(renderer, nullptr);
-    SDL_RenderSetClipRect(renderer, nullptr);
+    Renderer::getInstance().resetViewport();
 }
 
 void Camera::end() {
     if (!visible) return;
 }
 
-void Camera::applyTransform(SDL_Rect& rect) {
-    if (!visible) return;
-    
-    rect.x = static_cast<int>(rect.x * zoom);
-    rect.y = static_cast<int>(rect.y * zoom);
-    rect.w = static_cast<int>(rect.w * zoom);
-    rect.h = static_cast<int>(rect.h * zoom);    
-    rect.x -= static_cast<int>(x * zoom);
-    rect.y -= static_cast<int>(y * zoom);
+SDL_FRect Camera::getViewBounds() const {
+    SDL_FRect screen = screenBounds();
+    if (!visible || zoom <= 0.0f) return screen;
+    return { x, y, screen.w / zoom, screen.h / zoom };
+}
+
+bool Camera::isInView(const SDL_FRect& worldRect) const {
+    if (!Engine::getInstance()) return true;
+    return overlaps(normalized(worldRect), getViewBounds());
+}
+
+bool Camera::isOnScreen(const SDL_FRect& screenRect) {
+    if (!Engine::getInstance()) return true;
+    return overlaps(normalized(screenRect), screenBounds());
 }
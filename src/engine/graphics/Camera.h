@@ -1,5 +1,6 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include "Transform2D.h"
 
 class Camera {
 public:
@@ -25,5 +26,19 @@ public:
         return zoom;
     }
     
-    void applyTransform(SDL_Rect& rect);
+    // World to screen: scale by zoom, then subtract the zoomed scroll position.
+    // Draws record world-space rects and the renderer applies this to whole
+    // vertex runs at replay, so no per-sprite rounding happens.
+    Transform2D getTransform() const {
+        if (!visible) return Transform2D();
+        return Transform2D::scaleTranslate(zoom, zoom, -x * zoom, -y * zoom);
+    }
+
+    // World-space area this camera shows: the window divided by zoom, offset by
+    // the scroll position. Invisible cameras don't transform, so they see the screen.
+    SDL_FRect getViewBounds() const;
+    // Whether a world-space rect overlaps the view; use before building draw rects.
+    bool isInView(const SDL_FRect& worldRect) const;
+    // Same test for things drawn in screen space without a camera.
+    static bool isOnScreen(const SDL_FRect& screenRect);
 };
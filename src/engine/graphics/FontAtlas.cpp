@@ -0,0 +1,111 @@
+#include "FontAtlas.h"
+#include "Renderer.h"
+#include "../utils/Log.h"
+#include <algorithm>
+#include <vector>
+
+std::mutex FontAtlas::cacheMutex;
+std::map<std::pair<std::string, int>, std::unique_ptr<FontAtlas>> FontAtlas::cache;
+
+FontAtlas* FontAtlas::get(const std::string& fontPath, int size) {
+    std::pair<std::string, int> key(fontPath, size);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) return it->second.get();
+    }
+
+    // Built outside the lock: the texture upload may wait on the main thread.
+    std::unique_ptr<FontAtlas> atlas(new FontAtlas());
+    if (!atlas->build(fontPath, size)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto result = cache.emplace(key, std::move(atlas));
+    return result.first->second.get();
+}
+
+void FontAtlas::clearCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+}
+
+FontAtlas::~FontAtlas() {
+    if (texture) {
+        Renderer::getInstance().destroyTexture(texture);
+    }
+    if (font) {
+        TTF_CloseFont(font);
+    }
+}
+
+bool FontAtlas::build(const std::string& fontPath, int size) {
+    font = TTF_OpenFont(fontPath.c_str(), size);
+    if (!font) {
+        Log::getInstance().error("Failed to load font: " + std::string(TTF_GetError()));
+        return false;
+    }
+    lineHeight = TTF_FontHeight(font);
+    kerning = TTF_GetFontKerning(font) != 0;
+
+    // Render each glyph white and shelf-pack them left to right.
+    const SDL_Color white = { 255, 255, 255, 255 };
+    std::vector<SDL_Surface*> rendered(LAST_GLYPH - FIRST_GLYPH + 1, nullptr);
+    int penX = 0, penY = 0, shelfHeight = 0;
+    for (int c = FIRST_GLYPH; c <= LAST_GLYPH; c++) {
+        Glyph& glyph = glyphs[c - FIRST_GLYPH];
+        int minX, maxX, minY, maxY;
+        if (TTF_GlyphMetrics32(font, static_cast<Uint32>(c), &minX, &maxX, &minY, &maxY, &glyph.advance) != 0) {
+            continue;
+        }
+
+        SDL_Surface* surface = TTF_RenderGlyph32_Blended(font, static_cast<Uint32>(c), white);
+        if (!surface) continue;
+        rendered[c - FIRST_GLYPH] = surface;
+
+        if (penX + surface->w > ATLAS_WIDTH) {
+            penX = 0;
+            penY += shelfHeight + 1;
+            shelfHeight = 0;
+        }
+        glyph.source = { penX, penY, surface->w, surface->h };
+        penX += surface->w + 1;
+        shelfHeight = std::max(shelfHeight, surface->h);
+    }
+
+    int atlasHeight = penY + shelfHeight;
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, std::max(atlasHeight, 1), 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlas) {
+        Log::getInstance().error("Failed to create font atlas surface: " + std::string(SDL_GetError()));
+        for (SDL_Surface* surface : rendered) SDL_FreeSurface(surface);
+        return false;
+    }
+    SDL_FillRect(atlas, nullptr, SDL_MapRGBA(atlas->format, 255, 255, 255, 0));
+    for (int c = FIRST_GLYPH; c <= LAST_GLYPH; c++) {
+        SDL_Surface* surface = rendered[c - FIRST_GLYPH];
+        if (!surface) continue;
+        SDL_Rect dest = glyphs[c - FIRST_GLYPH].source;
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(surface, nullptr, atlas, &dest);
+        SDL_FreeSurface(surface);
+    }
+
+    texture = Renderer::getInstance().createTexture(atlas);
+    SDL_FreeSurface(atlas);
+    if (!texture) {
+        Log::getInstance().error("Failed to create font atlas texture: " + std::string(SDL_GetError()));
+        return false;
+    }
+    return true;
+}
+
+const FontAtlas::Glyph& FontAtlas::getGlyph(unsigned char c) const {
+    if (c < FIRST_GLYPH || c > LAST_GLYPH) c = '?';
+    return glyphs[c - FIRST_GLYPH];
+}
+
+int FontAtlas::getKerning(unsigned char previous, unsigned char c) const {
+    if (!kerning || !previous) return 0;
+    return TTF_GetFontKerningSizeGlyphs32(font, previous, c);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+// Every printable ASCII glyph of one font at one size, rasterized once into a
+// single white texture. Text lays strings out against the glyph table and
+// draws quads from the texture, tinting through vertex colour, so changing or
+// redrawing text never touches TTF or uploads anything.
+class FontAtlas {
+public:
+    struct Glyph {
+        SDL_Rect source = { 0, 0, 0, 0 };
+        int advance = 0;
+    };
+
+    // Shared atlas for (fontPath, size); built on first use. Thread-safe.
+    static FontAtlas* get(const std::string& fontPath, int size);
+    // Destroys every atlas. Call before the renderer and SDL_ttf shut down.
+    static void clearCache();
+
+    ~FontAtlas();
+    FontAtlas(const FontAtlas&) = delete;
+    FontAtlas& operator=(const FontAtlas&) = delete;
+
+    // Characters outside the atlas fall back to '?'.
+    const Glyph& getGlyph(unsigned char c) const;
+    int getKerning(unsigned char previous, unsigned char c) const;
+    int getLineHeight() const { return lineHeight; }
+    SDL_Texture* getTexture() const { return texture; }
+
+private:
+    static constexpr unsigned char FIRST_GLYPH = 32;
+    static constexpr unsigned char LAST_GLYPH = 126;
+    static constexpr int ATLAS_WIDTH = 512;
+
+    FontAtlas() = default;
+    bool build(const std::string& fontPath, int size);
+
+    TTF_Font* font = nullptr;
+    SDL_Texture* texture = nullptr;
+    int lineHeight = 0;
+    bool kerning = false;
+    Glyph glyphs[LAST_GLYPH - FIRST_GLYPH + 1];
+
+    static std::mutex cacheMutex;
+    static std::map<std::pair<std::string, int>, std::unique_ptr<FontAtlas>> cache;
+};
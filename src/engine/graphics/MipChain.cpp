@@ -0,0 +1,89 @@
+#include "MipChain.h"
+#include "Renderer.h"
+#include "TextureImporter.h"
+#include "../core/Engine.h"
+#include <algorithm>
+#include <cmath>
+
+std::mutex MipChain::registryMutex;
+std::vector<MipChain*> MipChain::registry;
+Uint32 MipChain::evictionDelay = 3000;
+
+std::shared_ptr<MipChain> MipChain::build(SDL_Surface* imported) {
+    if (!imported || (imported->w < MIN_SIZE && imported->h < MIN_SIZE)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<MipChain> chain(new MipChain());
+    SDL_Surface* previous = imported;
+    for (int level = 1; level < LEVELS; level++) {
+        SDL_Surface* reduced = TextureImporter::downsample(previous);
+        if (!reduced) break;
+        chain->levels[level].surface = reduced;
+        previous = reduced;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.push_back(chain.get());
+    return chain;
+}
+
+MipChain::~MipChain() {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+    }
+    for (Level& level : levels) {
+        if (level.texture) {
+            Renderer::getInstance().destroyTexture(level.texture);
+        }
+        if (level.surface) {
+            SDL_FreeSurface(level.surface);
+        }
+    }
+}
+
+int MipChain::selectLevel(float scale) {
+    if (!(scale > 0.0f) || scale > LEVEL_THRESHOLD) return 0;
+    // Level n is picked from scale 0.75 / 2^(n-1) down: the nearest level in
+    // log2 terms, so a level's texels are magnified at most 1.5x on screen.
+    float level = std::floor(std::log2(LEVEL_THRESHOLD / scale)) + 1.0f;
+    return static_cast<int>(std::min(level, static_cast<float>(LEVELS - 1)));
+}
+
+SDL_Texture* MipChain::getLevel(int level) {
+    if (level <= 0 || level >= LEVELS || !levels[level].surface) return nullptr;
+
+    Level& entry = levels[level];
+    if (!entry.texture) {
+        entry.texture = Renderer::getInstance().createTexture(entry.surface);
+    }
+    Engine* engine = Engine::getInstance();
+    entry.lastUsed = engine ? engine->getTicks() : SDL_GetTicks();
+    return entry.texture;
+}
+
+SDL_Rect MipChain::scaleRect(const SDL_Rect& rect, int level) {
+    // Round outwards so odd-sized frames keep their edge texels.
+    int x0 = rect.x >> level;
+    int y0 = rect.y >> level;
+    int x1 = (rect.x + rect.w + (1 << level) - 1) >> level;
+    int y1 = (rect.y + rect.h + (1 << level) - 1) >> level;
+    return { x0, y0, x1 - x0, y1 - y0 };
+}
+
+void MipChain::setEvictionDelay(Uint32 milliseconds) {
+    evictionDelay = milliseconds;
+}
+
+void MipChain::evictUnused(Uint32 now) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (MipChain* chain : registry) {
+        for (Level& level : chain->levels) {
+            if (level.texture && now - level.lastUsed > evictionDelay) {
+                Renderer::getInstance().destroyTexture(level.texture);
+                level.texture = nullptr;
+            }
+        }
+    }
+}
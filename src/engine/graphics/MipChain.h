@@ -0,0 +1,54 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Half and quarter resolution copies of a large image, for drawing it zoomed
+// out without sampling the full texture. The reduced pixels are kept on the CPU
+// (a third of the original's size); their textures are only created when a
+// draw asks for that level and are destroyed again once unused for a while.
+class MipChain {
+public:
+    // Level 0 is the sprite's own texture.
+    static constexpr int LEVELS = 3;
+    // Images smaller than this on both sides don't get a chain.
+    static constexpr int MIN_SIZE = 1024;
+
+    // Chain for an imported surface, or nullptr when it is too small to bother.
+    static std::shared_ptr<MipChain> build(SDL_Surface* imported);
+
+    ~MipChain();
+    MipChain(const MipChain&) = delete;
+    MipChain& operator=(const MipChain&) = delete;
+
+    // Scale at and below which level 1 is used; each halving moves down a level.
+    static constexpr float LEVEL_THRESHOLD = 0.75f;
+
+    // Level to draw at scale screen pixels per level 0 texel.
+    static int selectLevel(float scale);
+    // Texture for level 1 or 2, created if needed; nullptr means draw level 0.
+    SDL_Texture* getLevel(int level);
+    // Maps a rect in level 0 texels to the same area in level.
+    static SDL_Rect scaleRect(const SDL_Rect& rect, int level);
+
+    // How long an unused level texture is kept. Default 3000 ms.
+    static void setEvictionDelay(Uint32 milliseconds);
+    // Destroys level textures not drawn within the eviction delay. Once per
+    // frame, on the thread that records draws; now is Engine::getTicks().
+    static void evictUnused(Uint32 now);
+
+private:
+    struct Level {
+        SDL_Surface* surface = nullptr;
+        SDL_Texture* texture = nullptr;
+        Uint32 lastUsed = 0;
+    };
+    Level levels[LEVELS];
+
+    MipChain() = default;
+
+    static std::mutex registryMutex;
+    static std::vector<MipChain*> registry;
+    static Uint32 evictionDelay;
+};
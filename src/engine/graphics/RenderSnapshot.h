@@ -0,0 +1,83 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Transform2D.h"
+
+// One draw, fully resolved (camera picked, frame picked, alpha baked in), so
+// replaying it never reads game objects that the simulation may be changing.
+// Texture rects are in the space of transforms[transform]; fills
+// are in screen space.
+struct RenderCommand {
+    enum class Type : Uint8 {
+        Clear,
+        FillRect,
+        Texture,
+        ResetViewport
+    };
+
+    Type type = Type::Clear;
+    SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    bool hasSource = false;
+    SDL_Color color = { 255, 255, 255, 255 };
+    SDL_Texture* texture = nullptr;
+    // Index into RenderSnapshot::transforms; 0 is the identity.
+    uint16_t transform = 0;
+    SDL_Rect source = { 0, 0, 0, 0 };
+    SDL_FRect dest = { 0, 0, 0, 0 };
+};
+
+// Everything needed to draw one frame.
+struct RenderSnapshot {
+    uint64_t sequence = 0;
+    // Draws skipped by visibility culling while recording; profiling only.
+    uint32_t culled = 0;
+    std::vector<RenderCommand> commands;
+    // Sort key per command, filled while recording.
+    std::vector<uint64_t> keys;
+    // Camera transforms used this frame, deduplicated as they are recorded.
+    std::vector<Transform2D> transforms = { Transform2D() };
+
+    RenderSnapshot() = default;
+    RenderSnapshot(const RenderSnapshot&) = delete;
+    RenderSnapshot& operator=(const RenderSnapshot&) = delete;
+    ~RenderSnapshot() { reset(); }
+
+    void reset() {
+        culled = 0;
+        commands.clear();
+        keys.clear();
+        transforms.assign(1, Transform2D());
+    }
+};
+
+// Lock-free triple buffer between one writer (simulation) and one reader (main
+// thread). The writer always has a free slot, so neither side ever waits; the
+// reader simply gets the newest finished snapshot and older ones are overwritten.
+class RenderSnapshotBuffer {
+public:
+    RenderSnapshot& beginWrite() { return slots[back]; }
+
+    void publish() {
+        back = shared.exchange(static_cast<Uint8>(back | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Returns the newest published snapshot, or nullptr if nothing new arrived
+    // since the last call. The pointer stays valid until the next acquire.
+    const RenderSnapshot* acquire() {
+        if (!(shared.load(std::memory_order_acquire) & FRESH)) return nullptr;
+        front = shared.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return &slots[front];
+    }
+
+private:
+    static constexpr Uint8 INDEX = 0x3;
+    static constexpr Uint8 FRESH = 0x4;
+
+    RenderSnapshot slots[3];
+    Uint8 back = 0;
+    std::atomic<Uint8> shared{ 1 };
+    Uint8 front = 2;
+};
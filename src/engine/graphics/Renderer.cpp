@@ -0,0 +1,472 @@
+#include "Renderer.h"
+#include "Camera.h"
+#include "../core/Engine.h"
+#include "../core/SDLManager.h"
+#include "TextureImporter.h"
+#include <algorithm>
+#include <future>
+
+static bool onMainThread() {
+    Engine* engine = Engine::getInstance();
+    return !engine || engine->getJobSystem().isMainThread();
+}
+
+void Renderer::beginRecording(RenderSnapshot& snapshot) {
+    snapshot.reset();
+    snapshot.sequence = recordingSequence.fetch_add(1, std::memory_order_acq_rel) + 1;
+    recording = &snapshot;
+    currentLayer = RenderLayer::World;
+    submissionCount = 0;
+    groupDepth = NO_GROUP;
+}
+
+void Renderer::endRecording() {
+    if (recording) {
+        sortCommands();
+    }
+    recording = nullptr;
+}
+
+void Renderer::beginGroup() {
+    groupDepth = std::min(submissionCount, MAX_DEPTH);
+}
+
+// Key, most significant first: layer (8) | depth (24) | texture (24) | blend (8).
+// The texture bits are a hash; a collision only means two textures at the
+// same depth aren't grouped.
+static uint64_t makeSortKey(RenderLayer layer, uint32_t depth, const RenderCommand& command) {
+    uint64_t texture = reinterpret_cast<uintptr_t>(command.texture);
+    uint64_t textureBits = ((texture >> 4) * 0x9E3779B97F4A7C15ull) >> 40;
+    return (static_cast<uint64_t>(layer) << 56) |
+           (static_cast<uint64_t>(depth & 0xFFFFFF) << 32) |
+           (textureBits << 8) |
+           (static_cast<uint64_t>(command.blendMode) & 0xFF);
+}
+
+void Renderer::submit(const RenderCommand& command) {
+    uint32_t depth = groupDepth != NO_GROUP ? groupDepth : std::min(submissionCount, MAX_DEPTH);
+    submissionCount++;
+    recording->keys.push_back(makeSortKey(currentLayer, depth, command));
+    recording->commands.push_back(command);
+}
+
+// Stable LSD radix sort of command indices by key, a byte per pass. Passes where
+// every key has the same byte are skipped, which is most of them in practice.
+static void radixSort(const std::vector<uint64_t>& keys, std::vector<uint32_t>& order, std::vector<uint32_t>& scratch) {
+    size_t count = keys.size();
+    order.resize(count);
+    scratch.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {};
+        for (size_t i = 0; i < count; i++) {
+            histogram[(keys[i] >> shift) & 0xFF]++;
+        }
+        if (histogram[(keys[0] >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (size_t& bucket : histogram) {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t index = order[i];
+            scratch[histogram[(keys[index] >> shift) & 0xFF]++] = index;
+        }
+        order.swap(scratch);
+    }
+}
+
+void Renderer::sortCommands() {
+    std::vector<uint64_t>& keys = recording->keys;
+    if (keys.size() < 2 || std::is_sorted(keys.begin(), keys.end())) return;
+
+    radixSort(keys, sortOrder, sortScratch);
+    sortedCommands.clear();
+    sortedCommands.reserve(recording->commands.size());
+    for (uint32_t index : sortOrder) {
+        sortedCommands.push_back(recording->commands[index]);
+    }
+    recording->commands.swap(sortedCommands);
+}
+
+uint16_t Renderer::recordTransform(const Camera* camera) {
+    if (!camera) return 0;
+
+    // A frame only uses a handful of cameras; search newest first.
+    Transform2D transform = camera->getTransform();
+    std::vector<Transform2D>& transforms = recording->transforms;
+    for (size_t i = transforms.size(); i-- > 0;) {
+        if (transforms[i] == transform) return static_cast<uint16_t>(i);
+    }
+    if (transforms.size() > UINT16_MAX) return 0;
+    transforms.push_back(transform);
+    return static_cast<uint16_t>(transforms.size() - 1);
+}
+
+void Renderer::clear(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    if (!recording) return;
+    RenderCommand command;
+    command.type = RenderCommand::Type::Clear;
+    command.color = { r, g, b, a };
+    submit(command);
+}
+
+void Renderer::fillRect(const SDL_Rect& rect, Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendMode blendMode) {
+    if (!recording) return;
+    RenderCommand command;
+    command.type = RenderCommand::Type::FillRect;
+    command.blendMode = blendMode;
+    command.color = { r, g, b, a };
+    command.dest = { static_cast<float>(rect.x), static_cast<float>(rect.y),
+                     static_cast<float>(rect.w), static_cast<float>(rect.h) };
+    submit(command);
+}
+
+void Renderer::drawTexture(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect& dest,
+                           float alpha, SDL_RendererFlip flip, SDL_BlendMode blendMode) {
+    SDL_FRect area = { static_cast<float>(dest.x), static_cast<float>(dest.y),
+                       static_cast<float>(dest.w), static_cast<float>(dest.h) };
+    drawTexture(texture, source, area, alpha, flip, blendMode);
+}
+
+void Renderer::drawTexture(SDL_Texture* texture, const SDL_Rect* source, const SDL_FRect& dest,
+                           float alpha, SDL_RendererFlip flip, SDL_BlendMode blendMode, const Camera* camera) {
+    if (!recording || !texture) return;
+    RenderCommand command;
+    command.type = RenderCommand::Type::Texture;
+    command.texture = texture;
+    command.flip = flip;
+    command.blendMode = blendMode;
+    command.color.a = static_cast<Uint8>(alpha * 255);
+    if (source) {
+        command.hasSource = true;
+        command.source = *source;
+    }
+    command.dest = dest;
+    command.transform = recordTransform(camera);
+    submit(command);
+}
+
+void Renderer::drawTexture(SDL_Texture* texture, const SDL_Rect* source, const SDL_FRect& dest,
+                           SDL_Color color, const Camera* camera) {
+    if (!recording || !texture) return;
+    RenderCommand command;
+    command.type = RenderCommand::Type::Texture;
+    command.texture = texture;
+    command.color = color;
+    if (source) {
+        command.hasSource = true;
+        command.source = *source;
+    }
+    command.dest = dest;
+    command.transform = recordTransform(camera);
+    submit(command);
+}
+
+void Renderer::resetViewport() {
+    if (!recording) return;
+    RenderCommand command;
+    command.type = RenderCommand::Type::ResetViewport;
+    submit(command);
+}
+
+// Straight-alpha blend modes as they apply to premultiplied texels.
+static SDL_BlendMode toPremultipliedMode(SDL_BlendMode mode) {
+    if (mode == SDL_BLENDMODE_BLEND) {
+        return Renderer::getPremultipliedBlendMode();
+    }
+    if (mode == SDL_BLENDMODE_ADD) {
+        static const SDL_BlendMode add = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD);
+        return add;
+    }
+    return mode;
+}
+
+// Vertex colours multiply the texel; with premultiplied texels, alpha has to
+// scale the colour channels too.
+static SDL_Color premultiplyColor(SDL_Color color) {
+    if (color.a == 255) return color;
+    auto scale = [&](Uint8 c) { return static_cast<Uint8>((c * color.a + 127) / 255); };
+    return { scale(color.r), scale(color.g), scale(color.b), color.a };
+}
+
+void Renderer::replay(const RenderSnapshot& snapshot) {
+    SDL_Renderer* renderer = SDLManager::getInstance().getRenderer();
+    if (software) {
+        software->replay(snapshot, renderer);
+        lastDrawCalls.store(software->getDrawCalls(), std::memory_order_relaxed);
+        lastSpriteCount.store(software->getSpriteCount(), std::memory_order_relaxed);
+        lastCulledCount.store(static_cast<int>(snapshot.culled), std::memory_order_relaxed);
+        lastStateChanges.store(0, std::memory_order_relaxed);
+        releaseDeferred(snapshot.sequence);
+        return;
+    }
+    int otherDrawCalls = 0;
+    int stateChanges = 0;
+
+    // Renderer draw state as last set this replay, to skip redundant calls.
+    bool drawColorKnown = false;
+    SDL_Color drawColor = { 0, 0, 0, 0 };
+    bool drawBlendKnown = false;
+    SDL_BlendMode drawBlend = SDL_BLENDMODE_NONE;
+    bool viewportReset = false;
+    auto setDrawColor = [&](const SDL_Color& color) {
+        if (drawColorKnown && color.r == drawColor.r && color.g == drawColor.g &&
+            color.b == drawColor.b && color.a == drawColor.a) return;
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        drawColor = color;
+        drawColorKnown = true;
+        stateChanges++;
+    };
+
+    batch.begin(renderer);
+    for (const RenderCommand& command : snapshot.commands) {
+        if (command.type == RenderCommand::Type::Texture) {
+            SDL_Color color = premultipliedTextures ? premultiplyColor(command.color) : command.color;
+            SDL_BlendMode blendMode = premultipliedTextures ? toPremultipliedMode(command.blendMode) : command.blendMode;
+            batch.draw(command.texture, command.hasSource ? &command.source : nullptr, command.dest,
+                       color, command.flip, blendMode, snapshot.transforms[command.transform]);
+            continue;
+        }
+
+        batch.flush();
+        switch (command.type) {
+            case RenderCommand::Type::Clear:
+                setDrawColor(command.color);
+                SDL_RenderClear(renderer);
+                break;
+            case RenderCommand::Type::FillRect:
+                if (!drawBlendKnown || drawBlend != command.blendMode) {
+                    SDL_SetRenderDrawBlendMode(renderer, command.blendMode);
+                    drawBlend = command.blendMode;
+                    drawBlendKnown = true;
+                    stateChanges++;
+                }
+                setDrawColor(command.color);
+                SDL_RenderFillRectF(renderer, &command.dest);
+                otherDrawCalls++;
+                break;
+            case RenderCommand::Type::Texture:
+                break;
+            case RenderCommand::Type::ResetViewport:
+                // Nothing sets a viewport or clip during replay, so once is enough.
+                if (!viewportReset) {
+                    SDL_RenderSetViewport(renderer, nullptr);
+                    SDL_RenderSetClipRect(renderer, nullptr);
+                    viewportReset = true;
+                    stateChanges += 2;
+                }
+                break;
+        }
+    }
+    batch.end();
+
+    lastDrawCalls.store(batch.getDrawCalls() + otherDrawCalls, std::memory_order_relaxed);
+    lastSpriteCount.store(batch.getQuadCount(), std::memory_order_relaxed);
+    lastCulledCount.store(static_cast<int>(snapshot.culled), std::memory_order_relaxed);
+    lastStateChanges.store(stateChanges + batch.getStateChanges(), std::memory_order_relaxed);
+    releaseDeferred(snapshot.sequence);
+}
+
+void Renderer::setSoftwareCompositing(bool enabled) {
+    if (enabled == (software != nullptr)) return;
+    software = enabled ? std::make_unique<SoftwareCompositor>() : nullptr;
+    if (enabled) {
+        renderTargets = false;
+    }
+}
+
+void Renderer::configureTextures() {
+    SDL_Renderer* renderer = SDLManager::getInstance().getRenderer();
+    SDL_RendererInfo info;
+    Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+    bool hasInfo = renderer && SDL_GetRendererInfo(renderer, &info) == 0;
+    if (hasInfo) {
+        for (Uint32 i = 0; i < info.num_texture_formats; i++) {
+            if (info.texture_formats[i] == SDL_PIXELFORMAT_ARGB8888 || info.texture_formats[i] == SDL_PIXELFORMAT_ABGR8888) {
+                format = info.texture_formats[i];
+                break;
+            }
+        }
+    }
+
+    // The software compositor always blends premultiplied. SDL's renderers need
+    // custom blend modes for it, which its software renderer lacks.
+    premultipliedTextures = software != nullptr;
+    if (!premultipliedTextures && renderer) {
+        SDL_Texture* probe = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, 1, 1);
+        premultipliedTextures = probe && SDL_SetTextureBlendMode(probe, getPremultipliedBlendMode()) == 0;
+        if (probe) {
+            SDL_DestroyTexture(probe);
+        }
+    }
+
+    // Cached layers need a target texture and both custom blend modes used to
+    // fill and draw it. The software renderer has no custom blend modes and
+    // composites on the CPU anyway, so a cached target saves nothing there.
+    renderTargets = false;
+    if (!software && hasInfo && (info.flags & SDL_RENDERER_TARGETTEXTURE) && !(info.flags & SDL_RENDERER_SOFTWARE)) {
+        SDL_Texture* probe = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 1, 1);
+        renderTargets = probe && SDL_SetTextureBlendMode(probe, getPremultiplyingBlendMode()) == 0 &&
+                        SDL_SetTextureBlendMode(probe, getPremultipliedBlendMode()) == 0;
+        if (probe) {
+            SDL_DestroyTexture(probe);
+        }
+    }
+
+    TextureImporter::configure(format, premultipliedTextures);
+    Log::getInstance().info(std::string("Textures: ") + SDL_GetPixelFormatName(TextureImporter::getFormat()) +
+                            (premultipliedTextures ? ", premultiplied alpha" : ", straight alpha") +
+                            (renderTargets ? ", cached layers" : ", no cached layers"));
+}
+
+// Imported surfaces match a format the renderer supports natively, so this is
+// a plain copy into the texture.
+static SDL_Texture* uploadTexture(SDL_Renderer* renderer, SDL_Surface* surface) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, surface->format->format, SDL_TEXTUREACCESS_STATIC, surface->w, surface->h);
+    if (!texture) return nullptr;
+    if (SDL_MUSTLOCK(surface)) SDL_LockSurface(surface);
+    SDL_UpdateTexture(texture, nullptr, surface->pixels, surface->pitch);
+    if (SDL_MUSTLOCK(surface)) SDL_UnlockSurface(surface);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+SDL_Texture* Renderer::createTexture(SDL_Surface* surface) {
+    if (!surface) return nullptr;
+    SDL_Surface* imported = TextureImporter::isImported(surface) ? surface : TextureImporter::import(surface);
+    if (!imported) return nullptr;
+
+    SDL_Renderer* renderer = SDLManager::getInstance().getRenderer();
+    SDL_Texture* created = nullptr;
+    if (onMainThread()) {
+        created = uploadTexture(renderer, imported);
+    } else {
+        std::promise<SDL_Texture*> result;
+        std::future<SDL_Texture*> texture = result.get_future();
+        Engine::getInstance()->getJobSystem().runOnMainThread([&result, renderer, imported] {
+            result.set_value(uploadTexture(renderer, imported));
+        });
+        created = texture.get();
+    }
+
+    if (created) {
+        std::lock_guard<std::mutex> lock(sizesMutex);
+        textureSizes[created] = { imported->w, imported->h };
+    }
+    if (software && created) {
+        software->addTexture(created, imported, TextureImporter::isPremultiplied());
+    }
+    if (imported != surface) {
+        SDL_FreeSurface(imported);
+    }
+    return created;
+}
+
+SDL_Texture* Renderer::renderToTexture(int width, int height, const std::function<void(SDL_Renderer*)>& draw) {
+    auto bake = [width, height, &draw]() -> SDL_Texture* {
+        SDL_Renderer* renderer = SDLManager::getInstance().getRenderer();
+        SDL_Texture* target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (!target) {
+            Log::getInstance().error("Failed to create render target: " + std::string(SDL_GetError()));
+            return nullptr;
+        }
+
+        SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+        SDL_SetRenderTarget(renderer, target);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        draw(renderer);
+        SDL_SetRenderTarget(renderer, previous);
+
+        SDL_SetTextureBlendMode(target, getPremultipliedBlendMode());
+        return target;
+    };
+
+    if (onMainThread()) {
+        return bake();
+    }
+
+    std::promise<SDL_Texture*> result;
+    std::future<SDL_Texture*> texture = result.get_future();
+    Engine::getInstance()->getJobSystem().runOnMainThread([&result, &bake] {
+        result.set_value(bake());
+    });
+    return texture.get();
+}
+
+SDL_BlendMode Renderer::getPremultiplyingBlendMode() {
+    // Straight-alpha source onto a premultiplied target.
+    static const SDL_BlendMode mode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_SRC_ALPHA, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    return mode;
+}
+
+SDL_BlendMode Renderer::getPremultipliedBlendMode() {
+    static const SDL_BlendMode mode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    return mode;
+}
+
+void Renderer::destroyTexture(SDL_Texture* texture) {
+    if (!texture) return;
+    if (onMainThread()) {
+        destroyNow(texture);
+        return;
+    }
+
+    // Snapshots recorded before the next one may still draw this texture.
+    std::lock_guard<std::mutex> lock(destroyMutex);
+    deferredDestroys.push_back({ recordingSequence.load(std::memory_order_acquire) + 1, texture });
+}
+
+void Renderer::releaseDeferred(uint64_t replayedSequence) {
+    std::lock_guard<std::mutex> lock(destroyMutex);
+    for (size_t i = 0; i < deferredDestroys.size();) {
+        if (deferredDestroys[i].safeAfter <= replayedSequence) {
+            destroyNow(deferredDestroys[i].texture);
+            deferredDestroys[i] = deferredDestroys.back();
+            deferredDestroys.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+
+bool Renderer::getTextureSize(SDL_Texture* texture, int& width, int& height) {
+    {
+        std::lock_guard<std::mutex> lock(sizesMutex);
+        auto it = textureSizes.find(texture);
+        if (it != textureSizes.end()) {
+            width = it->second.x;
+            height = it->second.y;
+            return true;
+        }
+    }
+    return onMainThread() && SDL_QueryTexture(texture, nullptr, nullptr, &width, &height) == 0;
+}
+
+void Renderer::destroyNow(SDL_Texture* texture) {
+    {
+        std::lock_guard<std::mutex> lock(sizesMutex);
+        textureSizes.erase(texture);
+    }
+    if (software) {
+        software->removeTexture(texture);
+    }
+    SDL_DestroyTexture(texture);
+}
+
+void Renderer::flushDestroyedTextures() {
+    releaseDeferred(UINT64_MAX);
+}
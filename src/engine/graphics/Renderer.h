@@ -0,0 +1,162 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "RenderSnapshot.h"
+#include "SoftwareCompositor.h"
+#include "SpriteBatch.h"
+
+class Camera;
+
+// Coarse draw order. Commands sort by layer first, so a state can submit its
+// groups in any order.
+enum class RenderLayer : Uint8 {
+    Background = 0,
+    World = 64,
+    Foreground = 128,
+    HUD = 192,
+    Overlay = 255
+};
+
+// All drawing goes through here. Draw calls are recorded into the snapshot that
+// Engine opened for the frame and are only turned into SDL calls by replay(),
+// which always runs on the main thread. That lets the simulation record frames
+// on its own thread while the main thread presents.
+//
+// Commands are sorted when recording ends by (layer, depth, texture, blend mode).
+// Depth defaults to submission order, which keeps painter's order; draws inside
+// beginGroup()/endGroup() share one depth, so they may be reordered to batch by
+// texture and must not depend on overlapping each other in order.
+class Renderer {
+public:
+    static Renderer& getInstance() {
+        static Renderer instance;
+        return instance;
+    }
+
+    void beginRecording(RenderSnapshot& snapshot);
+    void endRecording();
+    bool isRecording() const { return recording != nullptr; }
+
+    // Layer for the following commands; reset to World when recording begins.
+    void setLayer(RenderLayer layer) { currentLayer = layer; }
+    RenderLayer getLayer() const { return currentLayer; }
+    void beginGroup();
+    void endGroup() { groupDepth = NO_GROUP; }
+
+    void clear(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255);
+    void fillRect(const SDL_Rect& rect, Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND);
+    // source nullptr draws the whole texture. dest is in camera (world) space when
+    // a camera is given, screen space otherwise.
+    void drawTexture(SDL_Texture* texture, const SDL_Rect* source, const SDL_FRect& dest,
+                     float alpha = 1.0f, SDL_RendererFlip flip = SDL_FLIP_NONE,
+                     SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND, const Camera* camera = nullptr);
+    void drawTexture(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect& dest,
+                     float alpha = 1.0f, SDL_RendererFlip flip = SDL_FLIP_NONE,
+                     SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND);
+    // Tinted draw; color multiplies the texels, alpha included (used for glyphs).
+    void drawTexture(SDL_Texture* texture, const SDL_Rect* source, const SDL_FRect& dest,
+                     SDL_Color color, const Camera* camera = nullptr);
+    void resetViewport();
+    // Records that a draw was skipped because it was out of view.
+    void countCulled() { if (recording) recording->culled++; }
+
+    // Main thread only. Destroys textures that snapshots up to this one could use.
+    // Consecutive texture draws are merged by SpriteBatch.
+    void replay(const RenderSnapshot& snapshot);
+
+    // From the last replay; safe to read from any thread.
+    int getDrawCalls() const { return lastDrawCalls.load(std::memory_order_relaxed); }
+    int getSpriteCount() const { return lastSpriteCount.load(std::memory_order_relaxed); }
+    int getCulledCount() const { return lastCulledCount.load(std::memory_order_relaxed); }
+    // SDL texture/draw state calls actually issued (redundant ones are skipped).
+    int getStateChanges() const { return lastStateChanges.load(std::memory_order_relaxed); }
+
+    // Replays into the engine's own CPU framebuffer instead of through SDL's
+    // renderer (headless runs). Enable before any texture is created: only
+    // textures made after this have pixels the compositor can sample.
+    void setSoftwareCompositing(bool enabled);
+    SoftwareCompositor* getSoftwareCompositor() const { return software.get(); }
+
+    // Picks the format and alpha mode images are imported in (TextureImporter).
+    // Call once the SDL renderer exists, after setSoftwareCompositing.
+    void configureTextures();
+    // When true every texture made by createTexture holds premultiplied alpha;
+    // replay swaps in the matching blend modes, so draw calls don't change.
+    bool usesPremultipliedTextures() const { return premultipliedTextures; }
+
+    // Texture lifetime. Off the main thread, creation is handed to the main thread
+    // (the caller blocks until it's done) and destruction is deferred until no
+    // snapshot that might still be replayed can reference the texture.
+    // The surface is imported first unless it came from TextureImporter.
+    SDL_Texture* createTexture(SDL_Surface* surface);
+    void destroyTexture(SDL_Texture* texture);
+    // Size of a texture made by createTexture, recorded when it was made, so
+    // it can be read off the main thread. Other textures are only queried on
+    // the main thread; elsewhere this returns false.
+    bool getTextureSize(SDL_Texture* texture, int& width, int& height);
+    // Destroys every deferred texture now. Only safe when nothing is replaying.
+    void flushDestroyedTextures();
+
+    // Render-to-texture for caching static content. draw runs on the main thread
+    // with the new transparent target bound (callers off the main thread block
+    // until it's done). Draw into it with getPremultiplyingBlendMode() and draw the
+    // result with getPremultipliedBlendMode(), which the returned texture already uses.
+    // Probed once by configureTextures(); false means draw uncached.
+    bool supportsRenderTargets() const { return renderTargets; }
+    SDL_Texture* renderToTexture(int width, int height, const std::function<void(SDL_Renderer*)>& draw);
+    static SDL_BlendMode getPremultiplyingBlendMode();
+    static SDL_BlendMode getPremultipliedBlendMode();
+    // Render targets lose their contents on a device reset; bumped when that happens.
+    void notifyTargetsReset() { targetsGeneration.fetch_add(1, std::memory_order_relaxed); }
+    uint32_t getTargetsGeneration() const { return targetsGeneration.load(std::memory_order_relaxed); }
+
+private:
+    Renderer() = default;
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    struct DeferredDestroy {
+        uint64_t safeAfter;
+        SDL_Texture* texture;
+    };
+
+    static constexpr uint32_t NO_GROUP = UINT32_MAX;
+    static constexpr uint32_t MAX_DEPTH = (1u << 24) - 1;
+
+    RenderSnapshot* recording = nullptr;
+    std::atomic<uint64_t> recordingSequence{ 0 };
+
+    RenderLayer currentLayer = RenderLayer::World;
+    uint32_t submissionCount = 0;
+    uint32_t groupDepth = NO_GROUP;
+    // Recording-thread scratch for sorting.
+    std::vector<uint32_t> sortOrder;
+    std::vector<uint32_t> sortScratch;
+    std::vector<RenderCommand> sortedCommands;
+
+    SpriteBatch batch;
+    std::unique_ptr<SoftwareCompositor> software;
+    bool premultipliedTextures = false;
+    bool renderTargets = false;
+    std::atomic<int> lastDrawCalls{ 0 };
+    std::atomic<int> lastSpriteCount{ 0 };
+    std::atomic<int> lastCulledCount{ 0 };
+    std::atomic<int> lastStateChanges{ 0 };
+    std::atomic<uint32_t> targetsGeneration{ 0 };
+
+    std::mutex destroyMutex;
+    std::vector<DeferredDestroy> deferredDestroys;
+    std::mutex sizesMutex;
+    std::unordered_map<SDL_Texture*, SDL_Point> textureSizes;
+
+    void releaseDeferred(uint64_t replayedSequence);
+    void destroyNow(SDL_Texture* texture);
+    uint16_t recordTransform(const Camera* camera);
+    void submit(const RenderCommand& command);
+    void sortCommands();
+};
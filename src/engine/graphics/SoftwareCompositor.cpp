@@ -0,0 +1,464 @@
+#include "SoftwareCompositor.h"
+#include "../utils/Log.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMPOSITOR_SSE2 1
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define COMPOSITOR_AVX2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+#endif
+
+namespace {
+    enum class BlendOp {
+        Over,   // premultiplied source-over; also used for the custom premultiplied modes
+        Add,
+        Copy,
+        Mod,
+        Mul
+    };
+
+    BlendOp toBlendOp(SDL_BlendMode mode) {
+        switch (mode) {
+            case SDL_BLENDMODE_NONE: return BlendOp::Copy;
+            case SDL_BLENDMODE_ADD: return BlendOp::Add;
+            case SDL_BLENDMODE_MOD: return BlendOp::Mod;
+            case SDL_BLENDMODE_MUL: return BlendOp::Mul;
+            default: return BlendOp::Over;
+        }
+    }
+
+    // Exact round(c * m / 255) for c, m in 0..255. Every kernel uses this same
+    // formula so the SIMD paths match the scalar one bit for bit.
+    inline uint32_t mulDiv255(uint32_t c, uint32_t m) {
+        uint32_t t = c * m + 128;
+        return (t + (t >> 8)) >> 8;
+    }
+
+    inline uint32_t channel(uint32_t pixel, int shift) { return (pixel >> shift) & 0xFF; }
+
+    inline uint32_t pack(uint32_t a, uint32_t r, uint32_t g, uint32_t b) {
+        return (a << 24) | (r << 16) | (g << 8) | b;
+    }
+
+    // Multiplier per channel, premultiplied: texels already carry their alpha, so
+    // colour channels are scaled by tint * alpha and alpha by alpha alone.
+    uint32_t premultipliedModulate(SDL_Color color) {
+        return pack(color.a, mulDiv255(color.r, color.a), mulDiv255(color.g, color.a), mulDiv255(color.b, color.a));
+    }
+
+    void modulateScalar(uint32_t* row, int count, uint32_t mod) {
+        for (int i = 0; i < count; i++) {
+            uint32_t p = row[i];
+            row[i] = pack(mulDiv255(channel(p, 24), channel(mod, 24)), mulDiv255(channel(p, 16), channel(mod, 16)),
+                          mulDiv255(channel(p, 8), channel(mod, 8)), mulDiv255(channel(p, 0), channel(mod, 0)));
+        }
+    }
+
+    void blendScalar(uint32_t* dst, const uint32_t* src, int count, BlendOp op) {
+        for (int i = 0; i < count; i++) {
+            uint32_t s = src[i];
+            uint32_t d = dst[i];
+            uint32_t sa = channel(s, 24);
+            uint32_t out = 0;
+            switch (op) {
+                case BlendOp::Over: {
+                    uint32_t inv = 255 - sa;
+                    out = pack(std::min(255u, sa + mulDiv255(channel(d, 24), inv)),
+                               std::min(255u, channel(s, 16) + mulDiv255(channel(d, 16), inv)),
+                               std::min(255u, channel(s, 8) + mulDiv255(channel(d, 8), inv)),
+                               std::min(255u, channel(s, 0) + mulDiv255(channel(d, 0), inv)));
+                    break;
+                }
+                case BlendOp::Add:
+                    out = pack(channel(d, 24), std::min(255u, channel(s, 16) + channel(d, 16)),
+                               std::min(255u, channel(s, 8) + channel(d, 8)),
+                               std::min(255u, channel(s, 0) + channel(d, 0)));
+                    break;
+                case BlendOp::Copy:
+                    out = s;
+                    break;
+                case BlendOp::Mod:
+                    out = pack(channel(d, 24), mulDiv255(channel(s, 16), channel(d, 16)),
+                               mulDiv255(channel(s, 8), channel(d, 8)), mulDiv255(channel(s, 0), channel(d, 0)));
+                    break;
+                case BlendOp::Mul: {
+                    uint32_t inv = 255 - sa;
+                    uint32_t rgb[3];
+                    for (int c = 0; c < 3; c++) {
+                        int shift = 16 - c * 8;
+                        rgb[c] = std::min(255u, mulDiv255(channel(s, shift), channel(d, shift)) +
+                                                mulDiv255(channel(d, shift), inv));
+                    }
+                    out = pack(channel(d, 24), rgb[0], rgb[1], rgb[2]);
+                    break;
+                }
+            }
+            dst[i] = out;
+        }
+    }
+
+#ifdef COMPOSITOR_SSE2
+    // 16-bit lanes: round(x * m / 255), same rounding as mulDiv255.
+    inline __m128i mulDiv255x8(__m128i x, __m128i m) {
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(x, m), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    // (a, a, a, a) per pixel in 16-bit lanes, for the two pixels in lo and in hi.
+    inline void splatInverseAlpha(__m128i src, __m128i& lo, __m128i& hi) {
+        __m128i inv = _mm_sub_epi32(_mm_set1_epi32(255), _mm_srli_epi32(src, 24));
+        inv = _mm_or_si128(inv, _mm_slli_epi32(inv, 16));
+        lo = _mm_unpacklo_epi32(inv, inv);
+        hi = _mm_unpackhi_epi32(inv, inv);
+    }
+
+    int modulateSSE2(uint32_t* row, int count, uint32_t mod) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i m = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(mod)), zero);
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i lo = mulDiv255x8(_mm_unpacklo_epi8(p, zero), m);
+            __m128i hi = mulDiv255x8(_mm_unpackhi_epi8(p, zero), m);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+
+    int blendSSE2(uint32_t* dst, const uint32_t* src, int count, BlendOp op) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128i out;
+            if (op == BlendOp::Over) {
+                __m128i invLo, invHi;
+                splatInverseAlpha(s, invLo, invHi);
+                __m128i lo = mulDiv255x8(_mm_unpacklo_epi8(d, zero), invLo);
+                __m128i hi = mulDiv255x8(_mm_unpackhi_epi8(d, zero), invHi);
+                out = _mm_adds_epu8(s, _mm_packus_epi16(lo, hi));
+            } else {
+                // Add keeps the destination alpha.
+                __m128i sum = _mm_adds_epu8(_mm_andnot_si128(alphaMask, s), d);
+                out = _mm_or_si128(_mm_andnot_si128(alphaMask, sum), _mm_and_si128(alphaMask, d));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+        }
+        return i;
+    }
+#endif
+
+#ifdef COMPOSITOR_AVX2
+    AVX2_TARGET inline __m256i mulDiv255x16(__m256i x, __m256i m) {
+        __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(x, m), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+
+    // Unpack and pack work within 128-bit halves, so pixel order survives the round trip.
+    AVX2_TARGET int modulateAVX2(uint32_t* row, int count, uint32_t mod) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i m = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(mod)), zero);
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            __m256i lo = mulDiv255x16(_mm256_unpacklo_epi8(p, zero), m);
+            __m256i hi = mulDiv255x16(_mm256_unpackhi_epi8(p, zero), m);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), _mm256_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+
+    AVX2_TARGET int blendAVX2(uint32_t* dst, const uint32_t* src, int count, BlendOp op) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i out;
+            if (op == BlendOp::Over) {
+                __m256i inv = _mm256_sub_epi32(_mm256_set1_epi32(255), _mm256_srli_epi32(s, 24));
+                inv = _mm256_or_si256(inv, _mm256_slli_epi32(inv, 16));
+                __m256i lo = mulDiv255x16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi32(inv, inv));
+                __m256i hi = mulDiv255x16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi32(inv, inv));
+                out = _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi));
+            } else {
+                __m256i sum = _mm256_adds_epu8(_mm256_andnot_si256(alphaMask, s), d);
+                out = _mm256_or_si256(_mm256_andnot_si256(alphaMask, sum), _mm256_and_si256(alphaMask, d));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), out);
+        }
+        return i;
+    }
+
+    const bool hasAVX2 = SDL_HasAVX2() == SDL_TRUE;
+#endif
+
+    void modulateRow(uint32_t* row, int count, uint32_t mod) {
+        if (mod == 0xFFFFFFFF) return;
+        int done = 0;
+#ifdef COMPOSITOR_AVX2
+        if (hasAVX2) done = modulateAVX2(row, count, mod);
+#endif
+#ifdef COMPOSITOR_SSE2
+        done += modulateSSE2(row + done, count - done, mod);
+#endif
+        modulateScalar(row + done, count - done, mod);
+    }
+
+    void blendRow(uint32_t* dst, const uint32_t* src, int count, BlendOp op) {
+        int done = 0;
+        if (op == BlendOp::Over || op == BlendOp::Add) {
+#ifdef COMPOSITOR_AVX2
+            if (hasAVX2) done = blendAVX2(dst, src, count, op);
+#endif
+#ifdef COMPOSITOR_SSE2
+            done += blendSSE2(dst + done, src + done, count - done, op);
+#endif
+        }
+        blendScalar(dst + done, src + done, count - done, op);
+    }
+
+    // Two channels at a time: f in 0..256 weights b against a.
+    inline uint32_t lerpPixel(uint32_t a, uint32_t b, uint32_t f) {
+        uint32_t rb = (((a & 0x00FF00FF) * (256 - f) + (b & 0x00FF00FF) * f) >> 8) & 0x00FF00FF;
+        uint32_t ag = (((a >> 8) & 0x00FF00FF) * (256 - f) + ((b >> 8) & 0x00FF00FF) * f) & 0xFF00FF00;
+        return rb | ag;
+    }
+
+    // Texel index and 8-bit fraction for a 16.16 coordinate, clamped to [low, high).
+    inline void clampTexel(int32_t coord, int low, int high, int& i0, int& i1, uint32_t& frac) {
+        int i = coord >> 16;
+        if (i < low) {
+            i0 = i1 = low;
+            frac = 0;
+        } else if (i >= high - 1) {
+            i0 = i1 = high - 1;
+            frac = 0;
+        } else {
+            i0 = i;
+            i1 = i + 1;
+            frac = (static_cast<uint32_t>(coord) >> 8) & 0xFF;
+        }
+    }
+}
+
+SoftwareCompositor::SoftwareCompositor() = default;
+
+SoftwareCompositor::~SoftwareCompositor() {
+    if (output) {
+        SDL_DestroyTexture(output);
+    }
+}
+
+bool SoftwareCompositor::toImage(SDL_Surface* surface, Image& image, bool premultiplied) {
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!converted) {
+        Log::getInstance().error("Software compositor could not convert surface: " + std::string(SDL_GetError()));
+        return false;
+    }
+    image.width = converted->w;
+    image.height = converted->h;
+    image.pixels.resize(static_cast<size_t>(image.width) * image.height);
+    if (premultiplied) {
+        for (int y = 0; y < image.height; y++) {
+            const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(converted->pixels) + y * converted->pitch);
+            std::copy(row, row + image.width, image.pixels.begin() + static_cast<size_t>(y) * image.width);
+        }
+    } else {
+        SDL_PremultiplyAlpha(image.width, image.height, SDL_PIXELFORMAT_ARGB8888, converted->pixels, converted->pitch,
+                             SDL_PIXELFORMAT_ARGB8888, image.pixels.data(), image.width * 4);
+    }
+    SDL_FreeSurface(converted);
+    return true;
+}
+
+void SoftwareCompositor::addTexture(SDL_Texture* texture, SDL_Surface* surface, bool premultiplied) {
+    if (!texture || !surface) return;
+    Image image;
+    if (!toImage(surface, image, premultiplied)) return;
+    std::lock_guard<std::mutex> lock(imagesMutex);
+    images[texture] = std::move(image);
+}
+
+void SoftwareCompositor::removeTexture(SDL_Texture* texture) {
+    std::lock_guard<std::mutex> lock(imagesMutex);
+    images.erase(texture);
+}
+
+void SoftwareCompositor::resize(int newWidth, int newHeight, SDL_Renderer* renderer) {
+    if (newWidth == width && newHeight == height && output) return;
+    width = newWidth;
+    height = newHeight;
+    framebuffer.assign(static_cast<size_t>(width) * height, 0);
+    rowScratch.resize(width);
+    if (output) {
+        SDL_DestroyTexture(output);
+    }
+    output = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!output) {
+        Log::getInstance().error("Software compositor could not create its output texture: " + std::string(SDL_GetError()));
+        return;
+    }
+    SDL_SetTextureBlendMode(output, SDL_BLENDMODE_NONE);
+}
+
+void SoftwareCompositor::clear(SDL_Color color) {
+    std::fill(framebuffer.begin(), framebuffer.end(), premultipliedModulate(color));
+}
+
+void SoftwareCompositor::fillRect(const SDL_FRect& rect, SDL_Color color, SDL_BlendMode blendMode) {
+    // Pixels whose centres fall inside the rect, like the GPU rasteriser.
+    int x0 = std::max(0, static_cast<int>(std::ceil(rect.x - 0.5f)));
+    int y0 = std::max(0, static_cast<int>(std::ceil(rect.y - 0.5f)));
+    int x1 = std::min(width, static_cast<int>(std::ceil(rect.x + rect.w - 0.5f)));
+    int y1 = std::min(height, static_cast<int>(std::ceil(rect.y + rect.h - 0.5f)));
+    if (x0 >= x1 || y0 >= y1) return;
+
+    std::fill(rowScratch.begin(), rowScratch.begin() + (x1 - x0), premultipliedModulate(color));
+    BlendOp op = toBlendOp(blendMode);
+    for (int y = y0; y < y1; y++) {
+        blendRow(&framebuffer[static_cast<size_t>(y) * width + x0], rowScratch.data(), x1 - x0, op);
+    }
+    drawCalls++;
+}
+
+void SoftwareCompositor::drawImage(const Image& image, const SDL_Rect* source, const SDL_FRect& area,
+                                   SDL_Color color, SDL_RendererFlip flip, SDL_BlendMode blendMode) {
+    // Negative sizes come from mirrored scales; like SpriteBatch, draw the same
+    // area either way and leave mirroring to flip.
+    SDL_FRect dest = area;
+    if (dest.w < 0) { dest.x += dest.w; dest.w = -dest.w; }
+    if (dest.h < 0) { dest.y += dest.h; dest.h = -dest.h; }
+
+    SDL_Rect src = source ? *source : SDL_Rect{ 0, 0, image.width, image.height };
+    SDL_Rect bounds = { 0, 0, image.width, image.height };
+    if (!SDL_IntersectRect(&src, &bounds, &src) || dest.w <= 0 || dest.h <= 0) return;
+
+    int x0 = std::max(0, static_cast<int>(std::ceil(dest.x - 0.5f)));
+    int y0 = std::max(0, static_cast<int>(std::ceil(dest.y - 0.5f)));
+    int x1 = std::min(width, static_cast<int>(std::ceil(dest.x + dest.w - 0.5f)));
+    int y1 = std::min(height, static_cast<int>(std::ceil(dest.y + dest.h - 0.5f)));
+    if (x0 >= x1 || y0 >= y1) return;
+
+    // Texel coordinate (texel centres on integers) of each destination pixel
+    // centre, in 16.16 fixed point, stepping per pixel.
+    double scaleX = src.w / static_cast<double>(dest.w);
+    double scaleY = src.h / static_cast<double>(dest.h);
+    bool flipX = (flip & SDL_FLIP_HORIZONTAL) != 0;
+    bool flipY = (flip & SDL_FLIP_VERTICAL) != 0;
+    double offsetX = flipX ? dest.x + dest.w - (x0 + 0.5) : (x0 + 0.5) - dest.x;
+    double offsetY = flipY ? dest.y + dest.h - (y0 + 0.5) : (y0 + 0.5) - dest.y;
+    int32_t u0 = static_cast<int32_t>(std::lround((src.x + offsetX * scaleX - 0.5) * 65536.0));
+    int32_t v = static_cast<int32_t>(std::lround((src.y + offsetY * scaleY - 0.5) * 65536.0));
+    int32_t du = static_cast<int32_t>(std::lround(scaleX * 65536.0)) * (flipX ? -1 : 1);
+    int32_t dv = static_cast<int32_t>(std::lround(scaleY * 65536.0)) * (flipY ? -1 : 1);
+
+    int count = x1 - x0;
+    // 1:1 and texel-aligned: every sample lands on one texel, so copy the row.
+    bool exact = du == 65536 && (u0 & 0xFFFF) == 0 && dv == 65536 && (v & 0xFFFF) == 0 &&
+                 (u0 >> 16) >= src.x && (u0 >> 16) + count <= src.x + src.w;
+
+    uint32_t mod = premultipliedModulate(color);
+    BlendOp op = toBlendOp(blendMode);
+    uint32_t* row = rowScratch.data();
+    for (int y = y0; y < y1; y++, v += dv) {
+        int ty0, ty1;
+        uint32_t fy;
+        clampTexel(v, src.y, src.y + src.h, ty0, ty1, fy);
+        const uint32_t* top = &image.pixels[static_cast<size_t>(ty0) * image.width];
+        const uint32_t* bottom = &image.pixels[static_cast<size_t>(ty1) * image.width];
+
+        if (exact) {
+            std::copy(top + (u0 >> 16), top + (u0 >> 16) + count, row);
+        } else {
+            int32_t u = u0;
+            for (int i = 0; i < count; i++, u += du) {
+                int tx0, tx1;
+                uint32_t fx;
+                clampTexel(u, src.x, src.x + src.w, tx0, tx1, fx);
+                uint32_t upper = lerpPixel(top[tx0], top[tx1], fx);
+                uint32_t lower = lerpPixel(bottom[tx0], bottom[tx1], fx);
+                row[i] = lerpPixel(upper, lower, fy);
+            }
+        }
+
+        modulateRow(row, count, mod);
+        blendRow(&framebuffer[static_cast<size_t>(y) * width + x0], row, count, op);
+    }
+    drawCalls++;
+    spriteCount++;
+}
+
+void SoftwareCompositor::replay(const RenderSnapshot& snapshot, SDL_Renderer* renderer) {
+    int outputWidth = 0, outputHeight = 0;
+    SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+    resize(outputWidth, outputHeight, renderer);
+    drawCalls = 0;
+    spriteCount = 0;
+
+    std::lock_guard<std::mutex> lock(imagesMutex);
+    for (const RenderCommand& command : snapshot.commands) {
+        const Transform2D& transform = snapshot.transforms[command.transform];
+        switch (command.type) {
+            case RenderCommand::Type::Clear:
+                clear(command.color);
+                break;
+            case RenderCommand::Type::FillRect:
+                fillRect(command.dest, command.color, command.blendMode);
+                break;
+            case RenderCommand::Type::Texture: {
+                auto it = images.find(command.texture);
+                if (it == images.end()) {
+                    // Not made through Renderer::createTexture (e.g. render targets); nothing to sample.
+                    break;
+                }
+                drawImage(it->second, command.hasSource ? &command.source : nullptr, transform.apply(command.dest),
+                          command.color, command.flip, command.blendMode);
+                break;
+            }
+            case RenderCommand::Type::ResetViewport:
+                break;
+        }
+    }
+
+    if (output) {
+        SDL_UpdateTexture(output, nullptr, framebuffer.data(), width * 4);
+        SDL_RenderSetViewport(renderer, nullptr);
+        SDL_RenderCopy(renderer, output, nullptr, nullptr);
+    }
+}
+
+uint64_t SoftwareCompositor::getFrameHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(framebuffer.data());
+    for (size_t i = 0; i < framebuffer.size() * 4; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool SoftwareCompositor::saveFrame(const std::string& path) const {
+    if (framebuffer.empty()) return false;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint32_t*>(framebuffer.data()), width, height,
+                                                              32, width * 4, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) return false;
+    bool saved = SDL_SaveBMP(surface, path.c_str()) == 0;
+    SDL_FreeSurface(surface);
+    if (!saved) {
+        Log::getInstance().error("Failed to save frame to " + path + ": " + std::string(SDL_GetError()));
+    }
+    return saved;
+}
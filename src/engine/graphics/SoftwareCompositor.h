@@ -0,0 +1,71 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RenderSnapshot.h"
+
+// CPU rasteriser for headless runs. Replays the same sorted snapshot the GPU
+// path feeds to SpriteBatch, but into an engine-owned framebuffer, so output
+// doesn't depend on SDL's software renderer (per-pixel blits, nearest scaling).
+//
+// Everything is premultiplied ARGB8888 and all maths is integer, so a frame is
+// bit-identical whichever kernel (scalar, SSE2, AVX2) the CPU ends up using.
+// Textures are scaled with bilinear filtering, clamped to the source rect.
+class SoftwareCompositor {
+public:
+    SoftwareCompositor();
+    ~SoftwareCompositor();
+
+    SoftwareCompositor(const SoftwareCompositor&) = delete;
+    SoftwareCompositor& operator=(const SoftwareCompositor&) = delete;
+
+    // Keeps a premultiplied copy of surface's pixels as the image for texture.
+    // Any thread.
+    void addTexture(SDL_Texture* texture, SDL_Surface* surface, bool premultiplied = false);
+    void removeTexture(SDL_Texture* texture);
+
+    // Main thread. Composites the snapshot and copies the result to renderer's
+    // backbuffer, ready for present.
+    void replay(const RenderSnapshot& snapshot, SDL_Renderer* renderer);
+
+    // Last composited frame, premultiplied ARGB8888 (opaque after a clear).
+    const uint32_t* getPixels() const { return framebuffer.data(); }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // FNV-1a of the last frame, for golden-image comparisons.
+    uint64_t getFrameHash() const;
+    bool saveFrame(const std::string& path) const;
+
+    int getDrawCalls() const { return drawCalls; }
+    int getSpriteCount() const { return spriteCount; }
+
+private:
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::vector<uint32_t> pixels;
+    };
+
+    std::mutex imagesMutex;
+    std::unordered_map<SDL_Texture*, Image> images;
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> framebuffer;
+    // One destination row of sampled, tinted source pixels.
+    std::vector<uint32_t> rowScratch;
+    SDL_Texture* output = nullptr;
+
+    int drawCalls = 0;
+    int spriteCount = 0;
+
+    static bool toImage(SDL_Surface* surface, Image& image, bool premultiplied);
+    void resize(int newWidth, int newHeight, SDL_Renderer* renderer);
+    void clear(SDL_Color color);
+    void fillRect(const SDL_FRect& rect, SDL_Color color, SDL_BlendMode blendMode);
+    void drawImage(const Image& image, const SDL_Rect* source, const SDL_FRect& dest,
+                   SDL_Color color, SDL_RendererFlip flip, SDL_BlendMode blendMode);
+};
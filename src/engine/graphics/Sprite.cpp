@@ -1,6 +1,9 @@
 #include "Sprite.h"
 #include "Camera.h"
 #include "../core/SDLManager.h"
+#include "TextureImporter.h"
+#include "MipChain.h"
+#include <cmath>
 #include <iostream>
 
 Sprite::Sprite() 
@@ -17,8 +20,8 @@ Sprite::Sprite(const std::string& path)
 }
 
 Sprite::~Sprite() {
-    if (texture) {
-        SDL_DestroyTexture(texture);
+    if (texture && ownsTexture) {
+        Renderer::getInstance().destroyTexture(texture);
         texture = nullptr;
     }
 }
@@ -26,33 +29,58 @@ Sprite::~Sprite() {
 void Sprite::render() {
     if (!visible || !texture) return; 
 
-    SDL_SetTextureAlphaMod(texture, static_cast<Uint8>(alpha * 255));
+    SDL_FRect destRect = getWorldRect();
+    if (camera) {
+        if (!camera->isInView(destRect)) {
+            Renderer::getInstance().countCulled();
+            return;
+        }
+    }
 
-    SDL_Rect destRect;
-    destRect.x = static_cast<int>(x);
-    destRect.y = static_cast<int>(y);
-    destRect.w = static_cast<int>(width * scale.x);
-    destRect.h = static_cast<int>(height * scale.y);
+    float zoom = camera ? camera->getZoom() : 1.0f;
+    float screenScale = std::min(std::fabs(scale.x), std::fabs(scale.y)) * zoom;
+    Renderer::getInstance().drawTexture(selectMip(screenScale, nullptr), nullptr, destRect, alpha,
+                                        SDL_FLIP_NONE, SDL_BLENDMODE_BLEND, camera);
+}
 
-    if (camera) {
-        camera->applyTransform(destRect);
+SDL_Texture* Sprite::selectMip(float screenScale, SDL_Rect* source) const {
+    if (!mips) return texture;
+    int level = MipChain::selectLevel(screenScale);
+    SDL_Texture* reduced = level > 0 ? mips->getLevel(level) : nullptr;
+    if (!reduced) return texture;
+    if (source) {
+        *source = MipChain::scaleRect(*source, level);
     }
+    return reduced;
+}
 
-    SDL_RenderCopy(SDLManager::getInstance().getRenderer(), texture, nullptr, &destRect);
+SDL_FRect Sprite::getWorldRect() const {
+    SDL_FRect rect = { x, y, width * scale.x, height * scale.y };
+    if (camera) {
+        // Parallax moves the sprite against the scroll instead of changing the
+        // transform, so every sprite on a camera shares one.
+        rect.x += camera->x * (1.0f - scrollFactor.x);
+        rect.y += camera->y * (1.0f - scrollFactor.y);
+    }
+    return rect;
 }
 
 void Sprite::loadTexture(const std::string& imagePath) {
-    SDL_Surface* surface = IMG_Load(imagePath.c_str());
+    bool ownsSurface = false;
+    SDL_Surface* surface = TextureImporter::load(imagePath, ownsSurface);
     if (!surface) {
-        Log::getInstance().error("Failed to load image: " + imagePath);
         return;
     }
 
     width = surface->w;
     height = surface->h;
 
-    texture = SDL_CreateTextureFromSurface(SDLManager::getInstance().getRenderer(), surface);
-    SDL_FreeSurface(surface);
+    texture = Renderer::getInstance().createTexture(surface);
+    ownsTexture = true;
+    mips = MipChain::build(surface);
+    if (ownsSurface) {
+        SDL_FreeSurface(surface);
+    }
 
     if (!texture) {
         Log::getInstance().error("Failed to create texture from surface: " + std::string(SDL_GetError()));
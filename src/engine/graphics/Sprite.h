@@ -1,8 +1,11 @@
 #pragma once
 #include <string>
+#include <memory>
 #include <SDL2/SDL.h>
+#include "Renderer.h"
 
 class Camera;
+class MipChain;
 
 class Sprite {
 protected:
@@ -10,10 +13,16 @@ protected:
     std::string imagePath;
     float x = 0, y = 0;
     SDL_Texture* texture = nullptr;
+    // False when the texture is borrowed from a shared source (note skins, atlases).
+    bool ownsTexture = true;
     int width = 0;
     int height = 0;
     Camera* camera = nullptr;  
     float alpha = 1.0f;
+    // Reduced copies of texture for zoomed-out draws; only for large images.
+    std::shared_ptr<MipChain> mips;
+    // Texture and source rect to draw at screenScale (screen pixels per texel).
+    SDL_Texture* selectMip(float screenScale, SDL_Rect* source) const;
 
 public:
     struct Scale {
@@ -29,14 +38,21 @@ public:
 
     virtual void update(float deltaTime) {}
     virtual void render(); 
+    // Sizes width and height to what render() draws. A plain sprite draws its
+    // whole texture, which they already match.
+    virtual void updateHitbox() {}
 
     float getX() const { return x; }
     float getY() const { return y; }
     void setPosition(float newX, float newY) { x = newX; y = newY; }
 
     Scale scale;
+    // How much the sprite follows its camera's scroll: 1 moves with the world,
+    // 0 stays fixed on screen, values between give parallax.
+    Scale scrollFactor;
 
     void setScale(float scaleX, float scaleY);
+    void setScrollFactor(float factorX, float factorY) { scrollFactor.set(factorX, factorY); }
 
     int getWidth() const { return width; }
     int getHeight() const { return height; }
@@ -47,15 +63,22 @@ public:
     bool isVisible() const { return visible; }
 
     void setCamera(Camera* cam) { camera = cam; }
+    // Where render() places the sprite in its camera's world space, scroll factor included.
+    SDL_FRect getWorldRect() const;
+    SDL_Texture* getTexture() const { return texture; }
     Camera* getCamera() const { return camera; }
 
-    void setTexture(SDL_Texture* tex) { 
-        if (texture) {
-            SDL_DestroyTexture(texture);
+    // Pass takeOwnership = false for textures shared between sprites; only owned
+    // textures are destroyed when replaced or when the sprite dies.
+    void setTexture(SDL_Texture* tex, bool takeOwnership = true) { 
+        if (texture && ownsTexture && texture != tex) {
+            Renderer::getInstance().destroyTexture(texture);
         }
         texture = tex;
+        ownsTexture = takeOwnership;
+        mips.reset();
         if (texture) {
-            SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+            Renderer::getInstance().getTextureSize(texture, width, height);
         }
     }
 
@@ -0,0 +1,105 @@
+#include "SpriteBatch.h"
+#include "../utils/Log.h"
+#include <string>
+#include <utility>
+
+void SpriteBatch::begin(SDL_Renderer* target) {
+    renderer = target;
+    texture = nullptr;
+    positions.clear();
+    uvs.clear();
+    colors.clear();
+    indices.clear();
+    prepared.clear();
+    drawCalls = 0;
+    quadCount = 0;
+    stateChanges = 0;
+}
+
+void SpriteBatch::prepareTexture() {
+    for (PreparedTexture& entry : prepared) {
+        if (entry.texture != texture) continue;
+        if (entry.blendMode != blendMode) {
+            SDL_SetTextureBlendMode(texture, blendMode);
+            entry.blendMode = blendMode;
+            stateChanges++;
+        }
+        return;
+    }
+
+    // Vertex colours carry alpha and tint; clear any mods left on the texture.
+    // Done once per texture per frame.
+    SDL_SetTextureBlendMode(texture, blendMode);
+    SDL_SetTextureAlphaMod(texture, 255);
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    prepared.push_back({ texture, blendMode });
+    stateChanges += 3;
+}
+
+void SpriteBatch::draw(SDL_Texture* tex, const SDL_Rect* source, const SDL_FRect& dest,
+                       SDL_Color color, SDL_RendererFlip flip, SDL_BlendMode mode,
+                       const Transform2D& runTransform) {
+    if (!tex || dest.w == 0 || dest.h == 0) return;
+
+    if (tex != texture || mode != blendMode || runTransform != transform) {
+        flush();
+        blendMode = mode;
+        transform = runTransform;
+        if (tex != texture) {
+            texture = tex;
+            int w = 1, h = 1;
+            SDL_QueryTexture(tex, nullptr, nullptr, &w, &h);
+            textureWidth = static_cast<float>(w > 0 ? w : 1);
+            textureHeight = static_cast<float>(h > 0 ? h : 1);
+        }
+    }
+
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    if (source) {
+        u0 = source->x / textureWidth;
+        v0 = source->y / textureHeight;
+        u1 = (source->x + source->w) / textureWidth;
+        v1 = (source->y + source->h) / textureHeight;
+    }
+    if (flip & SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+    if (flip & SDL_FLIP_VERTICAL) std::swap(v0, v1);
+
+    // Negative sizes come from mirrored scales; draw the same area either way.
+    float x0 = dest.w < 0 ? dest.x + dest.w : dest.x;
+    float y0 = dest.h < 0 ? dest.y + dest.h : dest.y;
+    float x1 = x0 + (dest.w < 0 ? -dest.w : dest.w);
+    float y1 = y0 + (dest.h < 0 ? -dest.h : dest.h);
+
+    int base = static_cast<int>(colors.size());
+    positions.insert(positions.end(), { x0, y0, x1, y0, x1, y1, x0, y1 });
+    uvs.insert(uvs.end(), { u0, v0, u1, v0, u1, v1, u0, v1 });
+    colors.insert(colors.end(), { color, color, color, color });
+    indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+    quadCount++;
+}
+
+void SpriteBatch::flush() {
+    if (colors.empty()) return;
+
+    transform.apply(positions.data(), colors.size());
+
+    prepareTexture();
+    if (SDL_RenderGeometryRaw(renderer, texture,
+                              positions.data(), 2 * sizeof(float),
+                              colors.data(), sizeof(SDL_Color),
+                              uvs.data(), 2 * sizeof(float),
+                              static_cast<int>(colors.size()),
+                              indices.data(), static_cast<int>(indices.size()), sizeof(int)) < 0) {
+        static bool logged = false;
+        if (!logged) {
+            Log::getInstance().error("SDL_RenderGeometryRaw failed: " + std::string(SDL_GetError()));
+            logged = true;
+        }
+    }
+    drawCalls++;
+
+    positions.clear();
+    uvs.clear();
+    colors.clear();
+    indices.clear();
+}
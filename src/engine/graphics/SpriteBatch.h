@@ -0,0 +1,53 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Transform2D.h"
+
+// Collects textured quads and submits each run that shares a texture, blend
+// mode and camera transform as one SDL_RenderGeometryRaw call. Alpha, tint and
+// flip are baked into the vertices, so no per-sprite texture state is touched.
+// Positions are kept untransformed until flush, where the run's transform is
+// applied to the whole position array at once. Main thread only.
+class SpriteBatch {
+public:
+    void begin(SDL_Renderer* renderer);
+    // source nullptr uses the whole texture. dest is in the space of transform.
+    void draw(SDL_Texture* texture, const SDL_Rect* source, const SDL_FRect& dest,
+              SDL_Color color, SDL_RendererFlip flip, SDL_BlendMode blendMode,
+              const Transform2D& transform = Transform2D());
+    // Submits pending quads. Call before any other SDL draw so ordering holds.
+    void flush();
+    void end() { flush(); }
+
+    // Counters since begin().
+    int getDrawCalls() const { return drawCalls; }
+    int getQuadCount() const { return quadCount; }
+    int getStateChanges() const { return stateChanges; }
+
+private:
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* texture = nullptr;
+    SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
+    Transform2D transform;
+    float textureWidth = 1.0f;
+    float textureHeight = 1.0f;
+
+    // Interleaved x, y and u, v pairs, one colour per vertex.
+    std::vector<float> positions;
+    std::vector<float> uvs;
+    std::vector<SDL_Color> colors;
+    std::vector<int> indices;
+
+    // Textures whose blend mode and mods were already set this frame.
+    struct PreparedTexture {
+        SDL_Texture* texture;
+        SDL_BlendMode blendMode;
+    };
+    std::vector<PreparedTexture> prepared;
+
+    int drawCalls = 0;
+    int quadCount = 0;
+    int stateChanges = 0;
+
+    void prepareTexture();
+};
@@ -1,123 +1,84 @@
 #include "Text.h"
 #include "../core/SDLManager.h"
 #include "Camera.h"
-#include <iostream>
-#include <sstream>
+#include "FontAtlas.h"
+#include "Renderer.h"
 
 Text::Text(float x, float y, int z) 
     : x(x), y(y), width(0), height(0), text(""), color(0xFFFFFFFF),
-      fontSize(12), font(nullptr), texture(nullptr), isVisible(true),
+      fontSize(12), atlas(nullptr), isVisible(true),
       lineHeight(0), lineSpacing(1.2f) {
 }
 
-Text::~Text() {
-    if (texture) {
-        SDL_DestroyTexture(texture);
-        texture = nullptr;
-    }
-    if (font) {
-        TTF_CloseFont(font);
-        font = nullptr;
-    }
-}
+// The atlas is shared and owned by the FontAtlas cache.
+Text::~Text() {}
 
 void Text::setText(const std::string& text) {
+    if (text == this->text) return;
     this->text = text;
-    updateTexture();
+    updateLayout();
 }
 
 void Text::setFormat(const std::string& fontPath, int fontSize, unsigned int color) {
     this->fontSize = fontSize;
     this->color = color;
-    loadFont(fontPath);
-    updateTexture();
+    atlas = FontAtlas::get(fontPath, fontSize);
+    lineHeight = atlas ? static_cast<float>(atlas->getLineHeight()) : 0.0f;
+    updateLayout();
 }
 
-void Text::loadFont(const std::string& fontPath) {
-    if (font) {
-        TTF_CloseFont(font);
-    }
-    font = TTF_OpenFont(fontPath.c_str(), fontSize);
-    if (!font) {
-        Log::getInstance().error("Failed to load font: " + std::string(TTF_GetError()));
-        return;
-    }
-    
-    int fontHeight = TTF_FontHeight(font);
-    lineHeight = static_cast<float>(fontHeight);
-}
+void Text::updateLayout() {
+    quads.clear();
+    width = 0;
+    height = 0;
+    if (!atlas || text.empty()) return;
 
-void Text::updateTexture() {
-    if (!font || text.empty()) return;
-
-    if (texture) {
-        SDL_DestroyTexture(texture);
-        texture = nullptr;
-    }
-
-    std::istringstream iss(text);
-    std::string line;
+    float penX = 0;
+    float penY = 0;
     float maxWidth = 0;
-    int lineCount = 0;
-    
-    while (std::getline(iss, line)) {
-        int w, h;
-        TTF_SizeText(font, line.c_str(), &w, &h);
-        maxWidth = std::max(maxWidth, static_cast<float>(w));
-        lineCount++;
+    int lineCount = 1;
+    unsigned char previous = 0;
+    for (char ch : text) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (c == '\n') {
+            maxWidth = std::max(maxWidth, penX);
+            penX = 0;
+            penY += lineHeight * lineSpacing;
+            previous = 0;
+            lineCount++;
+            continue;
+        }
+
+        penX += static_cast<float>(atlas->getKerning(previous, c));
+        const FontAtlas::Glyph& glyph = atlas->getGlyph(c);
+        if (glyph.source.w > 0 && c != ' ') {
+            quads.push_back({ glyph.source, { penX, penY, static_cast<float>(glyph.source.w), static_cast<float>(glyph.source.h) } });
+        }
+        penX += static_cast<float>(glyph.advance);
+        previous = c;
     }
-    
-    width = maxWidth;
+    // A trailing newline doesn't start a visible line.
+    if (text.back() == '\n') lineCount--;
+
+    width = std::max(maxWidth, penX);
     height = static_cast<float>(lineCount) * lineHeight * lineSpacing;
 }
 
-void Text::renderText(const std::string& text, float x, float y) {
-    SDL_Color sdlColor = {
+void Text::render() {
+    if (!isVisible || !atlas || quads.empty()) return;
+
+    SDL_Color tint = {
         static_cast<Uint8>((color >> 24) & 0xFF),
         static_cast<Uint8>((color >> 16) & 0xFF),
         static_cast<Uint8>((color >> 8) & 0xFF),
-        static_cast<Uint8>(color & 0xFF)
+        static_cast<Uint8>((color & 0xFF) * alpha)
     };
 
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), sdlColor);
-    if (!surface) {
-        Log::getInstance().error("Failed to create text surface: " + std::string(TTF_GetError()));
-        return;
-    }
-
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(SDLManager::getInstance().getRenderer(), surface);
-    SDL_FreeSurface(surface);
-
-    if (!textTexture) {
-        Log::getInstance().error("Failed to create texture from surface: " + std::string(SDL_GetError()));
-        return;
-    }
-
-    SDL_Rect destRect;
-    destRect.x = static_cast<int>(x);
-    destRect.y = static_cast<int>(y);
-    SDL_QueryTexture(textTexture, nullptr, nullptr, &destRect.w, &destRect.h);
-    
-    SDL_SetTextureAlphaMod(textTexture, static_cast<Uint8>(alpha * 255));
-    
-    if (camera) {
-        camera->applyTransform(destRect);
-    }
-    
-    SDL_RenderCopy(SDLManager::getInstance().getRenderer(), textTexture, nullptr, &destRect);
-    SDL_DestroyTexture(textTexture);
-}
-
-void Text::render() {
-    if (!isVisible || !font) return;
-    
-    std::istringstream iss(text);
-    std::string line;
-    float currentY = y;
-    
-    while (std::getline(iss, line)) {
-        renderText(line, x, currentY);
-        currentY += lineHeight * lineSpacing;
+    Renderer& renderer = Renderer::getInstance();
+    SDL_Texture* texture = atlas->getTexture();
+    for (const GlyphQuad& quad : quads) {
+        SDL_FRect dest = { x + quad.dest.x, y + quad.dest.y, quad.dest.w, quad.dest.h };
+        renderer.drawTexture(texture, &quad.source, dest, tint, camera);
     }
 }
 
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
 #include <algorithm>
 
 class Camera;
+class FontAtlas;
 
+// Text drawn from a shared FontAtlas. The string is laid out into glyph quads
+// only when it or its format changes; render() just replays the quads.
 class Text {
 public:
     Text(float x = 0, float y = 0, int z = 0);
@@ -27,13 +30,13 @@ public:
     void setVisible(bool visible) { isVisible = visible; }
     bool getVisible() const { return isVisible; }
 
-    TTF_Font* getFont() const { return font; }
+    FontAtlas* getFontAtlas() const { return atlas; }
     const std::string& getText() const { return text; }
     float getX() const { return x; }
     float getY() const { return y; }
-    void setY(float newY) { y = newY; updateTexture(); }
+    void setY(float newY) { y = newY; }
     
-    void setAlpha(float alpha) { this->alpha = std::clamp(alpha, 0.0f, 1.0f); updateTexture(); }
+    void setAlpha(float alpha) { this->alpha = std::clamp(alpha, 0.0f, 1.0f); }
     float getAlpha() const { return alpha; }
     
     void setCamera(Camera* camera);
@@ -44,10 +47,14 @@ protected:
     float y;
 
 private:
-    void loadFont(const std::string& fontPath);
-    void updateTexture();
-    void renderText(const std::string& text, float x, float y);
+    struct GlyphQuad {
+        SDL_Rect source;
+        SDL_FRect dest;     // relative to the text position
+    };
 
+    void updateLayout();
+
+    std::vector<GlyphQuad> quads;
     std::string text;
     float width;
     float height;
@@ -55,8 +62,7 @@ private:
     float lineSpacing;
     unsigned int color;
     int fontSize;
-    TTF_Font* font;
-    SDL_Texture* texture;
+    FontAtlas* atlas;
     bool isVisible;
     float alpha = 1.0f;
     Camera* camera = nullptr;
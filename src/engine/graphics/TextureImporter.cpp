@@ -0,0 +1,190 @@
+#include "TextureImporter.h"
+#include "../core/AssetCache.h"
+#include "../utils/Log.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMPORTER_SSE2 1
+#endif
+
+namespace {
+    std::atomic<Uint32> targetFormat{ SDL_PIXELFORMAT_ARGB8888 };
+    std::atomic<bool> premultiplyAlpha{ false };
+    // Address stored in SDL_Surface::userdata to mark imported surfaces.
+    char importedTag;
+
+    inline uint32_t mulDiv255(uint32_t c, uint32_t m) {
+        uint32_t t = c * m + 128;
+        return (t + (t >> 8)) >> 8;
+    }
+
+    inline uint32_t swapRedBlue(uint32_t p) {
+        return (p & 0xFF00FF00) | ((p >> 16) & 0xFF) | ((p & 0xFF) << 16);
+    }
+
+    // Both layouts keep alpha in the top byte, so swapping bytes 0 and 2 converts
+    // between them. src and dst may be the same row.
+    void convertRow(const uint32_t* src, uint32_t* dst, int count, bool swap, bool premultiply) {
+        int i = 0;
+#ifdef IMPORTER_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i greenAlpha = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+        const __m128i low = _mm_set1_epi32(0xFF);
+        // 16-bit lanes 3 and 7 hold alpha; it is multiplied by 255 (kept as is).
+        const __m128i alphaLanes = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+        const __m128i alpha255 = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+        const __m128i rounding = _mm_set1_epi16(128);
+        for (; i + 4 <= count; i += 4) {
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            if (swap) {
+                p = _mm_or_si128(_mm_and_si128(p, greenAlpha),
+                                 _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), low),
+                                              _mm_slli_epi32(_mm_and_si128(p, low), 16)));
+            }
+            if (premultiply) {
+                __m128i alpha = _mm_srli_epi32(p, 24);
+                alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+                __m128i mulLo = _mm_or_si128(_mm_andnot_si128(alphaLanes, _mm_unpacklo_epi32(alpha, alpha)), alpha255);
+                __m128i mulHi = _mm_or_si128(_mm_andnot_si128(alphaLanes, _mm_unpackhi_epi32(alpha, alpha)), alpha255);
+                __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), mulLo), rounding);
+                __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), mulHi), rounding);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+                p = _mm_packus_epi16(lo, hi);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), p);
+        }
+#endif
+        for (; i < count; i++) {
+            uint32_t p = swap ? swapRedBlue(src[i]) : src[i];
+            if (premultiply) {
+                uint32_t a = p >> 24;
+                p = (a << 24) | (mulDiv255((p >> 16) & 0xFF, a) << 16) |
+                    (mulDiv255((p >> 8) & 0xFF, a) << 8) | mulDiv255(p & 0xFF, a);
+            }
+            dst[i] = p;
+        }
+    }
+}
+
+void TextureImporter::configure(Uint32 format, bool premultiply) {
+    if (format != SDL_PIXELFORMAT_ARGB8888 && format != SDL_PIXELFORMAT_ABGR8888) {
+        format = SDL_PIXELFORMAT_ARGB8888;
+    }
+    targetFormat = format;
+    premultiplyAlpha = premultiply;
+}
+
+Uint32 TextureImporter::getFormat() {
+    return targetFormat;
+}
+
+bool TextureImporter::isPremultiplied() {
+    return premultiplyAlpha;
+}
+
+bool TextureImporter::isImported(const SDL_Surface* surface) {
+    return surface && surface->userdata == &importedTag;
+}
+
+SDL_Surface* TextureImporter::import(SDL_Surface* source) {
+    if (!source) return nullptr;
+
+    Uint32 format = targetFormat;
+    bool premultiply = premultiplyAlpha;
+    Uint32 sourceFormat = source->format->format;
+    // 32-bit sources are converted in one pass; anything else (RGB, paletted,
+    // colour-keyed) goes through SDL's converter first, which also turns a
+    // colour key into alpha.
+    bool direct = (sourceFormat == SDL_PIXELFORMAT_ARGB8888 || sourceFormat == SDL_PIXELFORMAT_ABGR8888) &&
+                  !SDL_HasColorKey(source);
+
+    SDL_Surface* result = nullptr;
+    if (direct) {
+        result = SDL_CreateRGBSurfaceWithFormat(0, source->w, source->h, 32, format);
+        if (result) {
+            if (SDL_MUSTLOCK(source)) SDL_LockSurface(source);
+            for (int y = 0; y < source->h; y++) {
+                const uint32_t* srcRow = reinterpret_cast<const uint32_t*>(static_cast<const Uint8*>(source->pixels) + y * source->pitch);
+                uint32_t* dstRow = reinterpret_cast<uint32_t*>(static_cast<Uint8*>(result->pixels) + y * result->pitch);
+                convertRow(srcRow, dstRow, source->w, sourceFormat != format, premultiply);
+            }
+            if (SDL_MUSTLOCK(source)) SDL_UnlockSurface(source);
+        }
+    } else {
+        result = SDL_ConvertSurfaceFormat(source, format, 0);
+        if (result && premultiply) {
+            for (int y = 0; y < result->h; y++) {
+                uint32_t* row = reinterpret_cast<uint32_t*>(static_cast<Uint8*>(result->pixels) + y * result->pitch);
+                convertRow(row, row, result->w, false, true);
+            }
+        }
+    }
+
+    if (!result) {
+        Log::getInstance().error("Failed to import image: " + std::string(SDL_GetError()));
+        return nullptr;
+    }
+    // Blits from this surface must copy, not blend, or they'd undo the import.
+    SDL_SetSurfaceBlendMode(result, SDL_BLENDMODE_NONE);
+    result->userdata = &importedTag;
+    return result;
+}
+
+SDL_Surface* TextureImporter::downsample(SDL_Surface* imported) {
+    if (!isImported(imported)) return nullptr;
+
+    int width = (imported->w + 1) / 2;
+    int height = (imported->h + 1) / 2;
+    SDL_Surface* result = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, imported->format->format);
+    if (!result) {
+        Log::getInstance().error("Failed to downsample image: " + std::string(SDL_GetError()));
+        return nullptr;
+    }
+
+    for (int y = 0; y < height; y++) {
+        int y0 = y * 2;
+        int y1 = std::min(y0 + 1, imported->h - 1);
+        const uint32_t* top = reinterpret_cast<const uint32_t*>(static_cast<const Uint8*>(imported->pixels) + y0 * imported->pitch);
+        const uint32_t* bottom = reinterpret_cast<const uint32_t*>(static_cast<const Uint8*>(imported->pixels) + y1 * imported->pitch);
+        uint32_t* out = reinterpret_cast<uint32_t*>(static_cast<Uint8*>(result->pixels) + y * result->pitch);
+        for (int x = 0; x < width; x++) {
+            int x0 = x * 2;
+            int x1 = std::min(x0 + 1, imported->w - 1);
+            uint32_t a = top[x0], b = top[x1], c = bottom[x0], d = bottom[x1];
+            // Two channels per add; four bytes sum to at most 1020, so nothing carries.
+            uint32_t rb = (a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF) + 0x00020002;
+            uint32_t ag = ((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF) + ((c >> 8) & 0x00FF00FF) +
+                          ((d >> 8) & 0x00FF00FF) + 0x00020002;
+            out[x] = ((rb >> 2) & 0x00FF00FF) | (((ag >> 2) & 0x00FF00FF) << 8);
+        }
+    }
+
+    SDL_SetSurfaceBlendMode(result, SDL_BLENDMODE_NONE);
+    result->userdata = imported->userdata;
+    return result;
+}
+
+SDL_Surface* TextureImporter::decode(const std::string& path) {
+    SDL_Surface* decoded = IMG_Load(path.c_str());
+    if (!decoded) {
+        Log::getInstance().error("Failed to load image: " + path + " (" + IMG_GetError() + ")");
+        return nullptr;
+    }
+    SDL_Surface* imported = import(decoded);
+    SDL_FreeSurface(decoded);
+    return imported;
+}
+
+SDL_Surface* TextureImporter::load(const std::string& path, bool& owned) {
+    if (SDL_Surface* cached = AssetCache::getInstance().getSurface(path)) {
+        owned = false;
+        return cached;
+    }
+    SDL_Surface* surface = decode(path);
+    owned = surface != nullptr;
+    return surface;
+}
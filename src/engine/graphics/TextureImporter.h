@@ -0,0 +1,31 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string>
+
+// Puts decoded images in the layout textures are created from: the renderer's
+// preferred 32-bit format, with alpha premultiplied when the renderer draws that
+// way. Done once per image (on the loader thread when the image was preloaded),
+// so the upload is a straight copy and SDL never converts at draw or upload time.
+class TextureImporter {
+public:
+    // Called by Renderer once the SDL renderer exists. Until then images are
+    // imported as straight-alpha ARGB8888.
+    static void configure(Uint32 format, bool premultiply);
+    static Uint32 getFormat();
+    static bool isPremultiplied();
+
+    // New surface in the target layout, or nullptr. Any thread.
+    static SDL_Surface* import(SDL_Surface* source);
+    // True for surfaces returned by import() and downsample().
+    static bool isImported(const SDL_Surface* surface);
+    // Imported surface at half the size (rounded up), each texel the average of a
+    // 2x2 block. Averaging premultiplied texels keeps edges from darkening.
+    static SDL_Surface* downsample(SDL_Surface* imported);
+
+    // IMG_Load + import. Caller frees the result.
+    static SDL_Surface* decode(const std::string& path);
+    // Imported surface for path. One a state preloaded stays owned by AssetCache;
+    // otherwise it is decoded now, owned is set, and the caller frees it as soon
+    // as its texture exists, so no full-size copy outlives the upload.
+    static SDL_Surface* load(const std::string& path, bool& owned);
+};
@@ -0,0 +1,35 @@
+#include "Transform2D.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRANSFORM2D_SSE2 1
+#endif
+
+void Transform2D::apply(float* xy, size_t count) const {
+    size_t i = 0;
+#ifdef TRANSFORM2D_SSE2
+    // Two points per register: (x0, y0, x1, y1). The cross terms use the same
+    // points with x and y swapped.
+    const __m128 diagonal = _mm_setr_ps(a, d, a, d);
+    const __m128 cross = _mm_setr_ps(c, b, c, b);
+    const __m128 offset = _mm_setr_ps(tx, ty, tx, ty);
+    for (; i + 2 <= count; i += 2) {
+        __m128 points = _mm_loadu_ps(xy + i * 2);
+        __m128 swapped = _mm_shuffle_ps(points, points, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(points, diagonal), _mm_mul_ps(swapped, cross)), offset);
+        _mm_storeu_ps(xy + i * 2, result);
+    }
+#endif
+    for (; i < count; i++) {
+        float x = xy[i * 2];
+        float y = xy[i * 2 + 1];
+        xy[i * 2] = a * x + c * y + tx;
+        xy[i * 2 + 1] = b * x + d * y + ty;
+    }
+}
+
+SDL_FRect Transform2D::apply(const SDL_FRect& rect) const {
+    float corners[4] = { rect.x, rect.y, rect.x + rect.w, rect.y + rect.h };
+    apply(corners, 2);
+    return { corners[0], corners[1], corners[2] - corners[0], corners[3] - corners[1] };
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstddef>
+
+// 2D affine transform, column-major 2x3:
+//   x' = a * x + c * y + tx
+//   y' = b * x + d * y + ty
+struct Transform2D {
+    float a = 1.0f, b = 0.0f;
+    float c = 0.0f, d = 1.0f;
+    float tx = 0.0f, ty = 0.0f;
+
+    static Transform2D scaleTranslate(float scaleX, float scaleY, float translateX, float translateY) {
+        Transform2D t;
+        t.a = scaleX;
+        t.d = scaleY;
+        t.tx = translateX;
+        t.ty = translateY;
+        return t;
+    }
+
+    bool operator==(const Transform2D& o) const {
+        return a == o.a && b == o.b && c == o.c && d == o.d && tx == o.tx && ty == o.ty;
+    }
+    bool operator!=(const Transform2D& o) const { return !(*this == o); }
+
+    // Transforms count interleaved (x, y) points in place, two per SSE2 op where available.
+    void apply(float* xy, size_t count) const;
+    // Maps a rect through the transform; only exact for transforms without rotation.
+    SDL_FRect apply(const SDL_FRect& rect) const;
+};
@@ -0,0 +1,253 @@
+#include "VideoExporter.h"
+#include "Renderer.h"
+#include "../utils/Log.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <filesystem>
+
+VideoExporter::~VideoExporter() {
+    close();
+}
+
+bool VideoExporter::open(const std::string& outputPath, int frameWidth, int frameHeight, int frameRate) {
+    if (isOpen()) {
+        Log::getInstance().warning("Video export already running: " + path);
+        return false;
+    }
+
+    path = outputPath;
+    width = frameWidth;
+    height = frameHeight;
+    fps = std::max(1, frameRate);
+    y4m = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+    framesCaptured = 0;
+    writeFailed = false;
+    mix.clear();
+
+    if (y4m) {
+        stream = std::fopen(path.c_str(), "wb");
+        if (!stream) {
+            Log::getInstance().error("Failed to open video output: " + path);
+            return false;
+        }
+        // C420jpeg: full-range BT.601 with JPEG chroma siting, matching the conversion below.
+        std::fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    } else {
+        std::error_code error;
+        std::filesystem::create_directories(path, error);
+        if (error) {
+            Log::getInstance().error("Failed to create frame directory " + path + ": " + error.message());
+            return false;
+        }
+    }
+
+    for (Frame& frame : frames) {
+        frame.pixels.resize(static_cast<size_t>(width) * height);
+        available.push(&frame);
+    }
+    availableCount.release(POOL_SIZE);
+
+    int frequency = 0, channels = 0;
+    Uint16 format = 0;
+    if (Mix_QuerySpec(&frequency, &format, &channels) && format == AUDIO_S16SYS) {
+        audioRate = frequency;
+        audioChannels = channels;
+    } else {
+        audioRate = 0;
+        Log::getInstance().warning("Mixer isn't open as 16-bit; the export will have no audio");
+    }
+
+    writer = std::thread(&VideoExporter::writerLoop, this);
+    Log::getInstance().info("Exporting " + std::string(y4m ? "Y4M video" : "PNG frames") + " to " + path);
+    return true;
+}
+
+void VideoExporter::close() {
+    if (!isOpen()) return;
+
+    queued.push(nullptr);
+    queuedCount.release();
+    writer.join();
+
+    // Take the pool back so a later open() starts from an empty ring.
+    Frame* frame = nullptr;
+    while (availableCount.try_acquire()) {
+        available.pop(frame);
+    }
+    for (Frame& pooled : frames) {
+        std::vector<uint32_t>().swap(pooled.pixels);
+    }
+
+    if (stream) {
+        std::fclose(stream);
+        stream = nullptr;
+    }
+    writeMixdown();
+    Log::getInstance().info("Exported " + std::to_string(framesCaptured) + " frames to " + path);
+}
+
+void VideoExporter::captureFrame(SDL_Renderer* renderer) {
+    if (!isOpen()) return;
+
+    availableCount.acquire();
+    Frame* frame = nullptr;
+    available.pop(frame);
+
+    SoftwareCompositor* software = Renderer::getInstance().getSoftwareCompositor();
+    if (software && software->getWidth() == width && software->getHeight() == height) {
+        std::copy(software->getPixels(), software->getPixels() + frame->pixels.size(), frame->pixels.begin());
+    } else if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, frame->pixels.data(), width * 4) != 0) {
+        Log::getInstance().error("Failed to read back frame: " + std::string(SDL_GetError()));
+        std::fill(frame->pixels.begin(), frame->pixels.end(), 0xFF000000);
+    }
+
+    frame->index = framesCaptured++;
+    queued.push(frame);
+    queuedCount.release();
+}
+
+void VideoExporter::addAudioTrack(const Mix_Chunk* chunk) {
+    if (!isOpen() || !chunk || audioRate == 0) return;
+
+    // Whole frames, so audio and video stay in step however long the export runs.
+    size_t start = static_cast<size_t>(framesCaptured * audioRate / fps) * audioChannels;
+    const Sint16* samples = reinterpret_cast<const Sint16*>(chunk->abuf);
+    size_t count = chunk->alen / sizeof(Sint16);
+    if (mix.size() < start + count) {
+        mix.resize(start + count, 0);
+    }
+    for (size_t i = 0; i < count; i++) {
+        mix[start + i] += samples[i];
+    }
+}
+
+void VideoExporter::writerLoop() {
+    while (true) {
+        queuedCount.acquire();
+        Frame* frame = nullptr;
+        queued.pop(frame);
+        if (!frame) break;
+
+        if (!writeFailed) {
+            bool written = y4m ? writeY4M(*frame) : writePNG(*frame);
+            if (!written) {
+                // Keep draining so rendering never blocks on a broken output.
+                writeFailed = true;
+                Log::getInstance().error("Video export write failed at frame " + std::to_string(frame->index));
+            }
+        }
+
+        available.push(frame);
+        availableCount.release();
+    }
+}
+
+bool VideoExporter::writeY4M(const Frame& frame) {
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    size_t lumaSize = static_cast<size_t>(width) * height;
+    size_t chromaSize = static_cast<size_t>(chromaWidth) * chromaHeight;
+    planes.resize(lumaSize + chromaSize * 2);
+    uint8_t* yPlane = planes.data();
+    uint8_t* uPlane = yPlane + lumaSize;
+    uint8_t* vPlane = uPlane + chromaSize;
+
+    // Full-range BT.601 in 8.8 fixed point; chroma from the 2x2 block average.
+    for (int cy = 0; cy < chromaHeight; cy++) {
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int sumR = 0, sumG = 0, sumB = 0, samples = 0;
+            for (int dy = 0; dy < 2; dy++) {
+                int y = cy * 2 + dy;
+                if (y >= height) break;
+                for (int dx = 0; dx < 2; dx++) {
+                    int x = cx * 2 + dx;
+                    if (x >= width) break;
+                    uint32_t pixel = frame.pixels[static_cast<size_t>(y) * width + x];
+                    int r = (pixel >> 16) & 0xFF;
+                    int g = (pixel >> 8) & 0xFF;
+                    int b = pixel & 0xFF;
+                    yPlane[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+                    sumR += r;
+                    sumG += g;
+                    sumB += b;
+                    samples++;
+                }
+            }
+            int r = sumR / samples, g = sumG / samples, b = sumB / samples;
+            size_t c = static_cast<size_t>(cy) * chromaWidth + cx;
+            uPlane[c] = static_cast<uint8_t>(std::clamp(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128, 0, 255));
+            vPlane[c] = static_cast<uint8_t>(std::clamp(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128, 0, 255));
+        }
+    }
+
+    return std::fputs("FRAME\n", stream) >= 0 &&
+           std::fwrite(planes.data(), 1, planes.size(), stream) == planes.size();
+}
+
+bool VideoExporter::writePNG(const Frame& frame) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint32_t*>(frame.pixels.data()),
+                                                              width, height, 32, width * 4, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) return false;
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "/frame_%06llu.png", static_cast<unsigned long long>(frame.index));
+    bool saved = IMG_SavePNG(surface, (path + name).c_str()) == 0;
+    SDL_FreeSurface(surface);
+    return saved;
+}
+
+void VideoExporter::writeMixdown() {
+    if (audioRate == 0 || audioChannels == 0) return;
+
+    // Exactly as long as the video; silence where no track played.
+    size_t total = static_cast<size_t>(framesCaptured * audioRate / fps) * audioChannels;
+    mix.resize(total, 0);
+
+    std::string wavPath = path + ".wav";
+    FILE* file = std::fopen(wavPath.c_str(), "wb");
+    if (!file) {
+        Log::getInstance().error("Failed to open audio output: " + wavPath);
+        return;
+    }
+
+    auto write16 = [file](uint16_t value) {
+        uint8_t bytes[2] = { static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8) };
+        std::fwrite(bytes, 1, 2, file);
+    };
+    auto write32 = [file](uint32_t value) {
+        uint8_t bytes[4] = { static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+                             static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24) };
+        std::fwrite(bytes, 1, 4, file);
+    };
+
+    uint32_t dataSize = static_cast<uint32_t>(total * sizeof(Sint16));
+    std::fwrite("RIFF", 1, 4, file);
+    write32(36 + dataSize);
+    std::fwrite("WAVEfmt ", 1, 8, file);
+    write32(16);
+    write16(1);  // PCM
+    write16(static_cast<uint16_t>(audioChannels));
+    write32(static_cast<uint32_t>(audioRate));
+    write32(static_cast<uint32_t>(audioRate * audioChannels * sizeof(Sint16)));
+    write16(static_cast<uint16_t>(audioChannels * sizeof(Sint16)));
+    write16(16);
+    std::fwrite("data", 1, 4, file);
+    write32(dataSize);
+
+    std::vector<uint8_t> block;
+    block.reserve(64 * 1024);
+    for (size_t i = 0; i < total; i++) {
+        uint16_t sample = static_cast<uint16_t>(static_cast<Sint16>(std::clamp(mix[i], -32768, 32767)));
+        block.push_back(static_cast<uint8_t>(sample));
+        block.push_back(static_cast<uint8_t>(sample >> 8));
+        if (block.size() >= 64 * 1024) {
+            std::fwrite(block.data(), 1, block.size(), file);
+            block.clear();
+        }
+    }
+    std::fwrite(block.data(), 1, block.size(), file);
+    std::fclose(file);
+
+    std::vector<int32_t>().swap(mix);
+    Log::getInstance().info("Wrote audio mixdown to " + wavPath);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../utils/SpscRing.h"
+
+// Offline capture of presented frames. path ending in ".y4m" writes one raw
+// YUV4MPEG2 stream (4:2:0, full range); anything else is a directory that gets
+// a numbered PNG sequence. Audio registered with addAudioTrack() is mixed down
+// to a WAV next to it (path + ".wav") on close().
+//
+// Frames travel through a fixed pool of buffers: the main thread fills a free one
+// and queues it, the writer thread encodes it and hands it back. Nothing is
+// allocated per frame, and rendering only waits when every buffer is still queued.
+class VideoExporter {
+public:
+    VideoExporter() = default;
+    ~VideoExporter();
+
+    VideoExporter(const VideoExporter&) = delete;
+    VideoExporter& operator=(const VideoExporter&) = delete;
+
+    bool open(const std::string& path, int width, int height, int fps);
+    // Waits for queued frames, then writes the audio mixdown.
+    void close();
+    bool isOpen() const { return writer.joinable(); }
+
+    // Main thread, after replay and before present.
+    void captureFrame(SDL_Renderer* renderer);
+    // Mixes chunk in starting at the frame being rendered now. The samples are
+    // copied, so the chunk may be freed afterwards.
+    void addAudioTrack(const Mix_Chunk* chunk);
+
+    uint64_t getFramesCaptured() const { return framesCaptured; }
+
+private:
+    static constexpr size_t POOL_SIZE = 8;
+
+    struct Frame {
+        uint64_t index = 0;
+        std::vector<uint32_t> pixels;  // ARGB8888
+    };
+
+    std::string path;
+    bool y4m = false;
+    int width = 0;
+    int height = 0;
+    int fps = 60;
+    FILE* stream = nullptr;
+
+    Frame frames[POOL_SIZE];
+    SpscRing<Frame*, POOL_SIZE * 2> queued;     // main thread -> writer
+    SpscRing<Frame*, POOL_SIZE * 2> available;  // writer -> main thread
+    // One more than the pool, for the nullptr close() queues behind every frame.
+    std::counting_semaphore<POOL_SIZE + 1> queuedCount{ 0 };
+    std::counting_semaphore<POOL_SIZE> availableCount{ 0 };
+    std::thread writer;
+    std::atomic<bool> writeFailed{ false };
+    uint64_t framesCaptured = 0;
+
+    // Writer-thread scratch, reused for every frame.
+    std::vector<uint8_t> planes;
+
+    // Interleaved samples in the mixer's output format, summed at full precision.
+    std::vector<int32_t> mix;
+    int audioRate = 0;
+    int audioChannels = 0;
+
+    void writerLoop();
+    bool writeY4M(const Frame& frame);
+    bool writePNG(const Frame& frame);
+    void writeMixdown();
+};
@@ -9,15 +9,21 @@
 #include "../utils/Log.h"
 #include <SDL2/SDL.h>
 
+SpscRing<InputEvent, Input::EVENT_QUEUE_SIZE> Input::eventQueue;
+std::vector<InputEvent> Input::frameEvents;
+
 std::unordered_set<SDL_Scancode> Input::currentPressedKeys;
-std::unordered_set<SDL_Scancode> Input::previousPressedKeys;
+std::unordered_set<SDL_Scancode> Input::keysPressedThisUpdate;
+std::unordered_set<SDL_Scancode> Input::keysReleasedThisUpdate;
 
 std::unordered_map<Uint8, bool> Input::currentControllerState;
-std::unordered_map<Uint8, bool> Input::previousControllerState;
-std::unordered_map<SDL_GameControllerAxis, Sint16> Input::controllerAxisState;
+std::unordered_set<Uint8> Input::buttonsPressedThisUpdate;
+std::unordered_set<Uint8> Input::buttonsReleasedThisUpdate;
+std::atomic<Sint16> Input::controllerAxisState[SDL_CONTROLLER_AXIS_MAX];
 
 #ifdef __SWITCH__
 PadState Input::pad;
+u64 Input::polledButtons = 0;
 #else
 SDL_GameController* Input::sdlController = nullptr;
 #endif
@@ -69,34 +75,105 @@ void Input::closeController() {
     #endif
 }
 
-void Input::UpdateKeyStates() {
-    const Uint8* state = SDL_GetKeyboardState(NULL);
+void Input::queueEvent(const SDL_Event& event, Uint32 timestamp) {
+    InputEvent input;
+    input.timestamp = timestamp;
 
-    previousPressedKeys = currentPressedKeys;
-    currentPressedKeys.clear();
+    switch (event.type) {
+        case SDL_KEYDOWN:
+            if (event.key.repeat) return;
+            input.type = InputEvent::Type::KeyDown;
+            input.code = static_cast<Uint16>(event.key.keysym.scancode);
+            break;
+        case SDL_KEYUP:
+            input.type = InputEvent::Type::KeyUp;
+            input.code = static_cast<Uint16>(event.key.keysym.scancode);
+            break;
+        case SDL_CONTROLLERBUTTONDOWN:
+            input.type = InputEvent::Type::ButtonDown;
+            input.code = event.cbutton.button;
+            break;
+        case SDL_CONTROLLERBUTTONUP:
+            input.type = InputEvent::Type::ButtonUp;
+            input.code = event.cbutton.button;
+            break;
+        default:
+            return;
+    }
+    pushEvent(input);
+}
 
-    for (int i = 0; i < SDL_NUM_SCANCODES; ++i) {
-        if (state[i]) {
-            currentPressedKeys.insert(static_cast<SDL_Scancode>(i));
+void Input::pushEvent(const InputEvent& input) {
+    if (!eventQueue.push(input)) {
+        static bool logged = false;
+        if (!logged) {
+            Log::getInstance().warning("Input event queue full, dropping events");
+            logged = true;
         }
     }
 }
 
+void Input::applyEvent(const InputEvent& event) {
+    switch (event.type) {
+        case InputEvent::Type::KeyDown: {
+            SDL_Scancode key = static_cast<SDL_Scancode>(event.code);
+            currentPressedKeys.insert(key);
+            keysPressedThisUpdate.insert(key);
+            break;
+        }
+        case InputEvent::Type::KeyUp: {
+            SDL_Scancode key = static_cast<SDL_Scancode>(event.code);
+            currentPressedKeys.erase(key);
+            keysReleasedThisUpdate.insert(key);
+            break;
+        }
+        case InputEvent::Type::ButtonDown:
+            currentControllerState[static_cast<Uint8>(event.code)] = true;
+            buttonsPressedThisUpdate.insert(static_cast<Uint8>(event.code));
+            break;
+        case InputEvent::Type::ButtonUp:
+            currentControllerState[static_cast<Uint8>(event.code)] = false;
+            buttonsReleasedThisUpdate.insert(static_cast<Uint8>(event.code));
+            break;
+    }
+}
+
+void Input::UpdateKeyStates() {
+    keysPressedThisUpdate.clear();
+    keysReleasedThisUpdate.clear();
+    buttonsPressedThisUpdate.clear();
+    buttonsReleasedThisUpdate.clear();
+    frameEvents.clear();
+
+    InputEvent event;
+    while (eventQueue.pop(event)) {
+        applyEvent(event);
+        frameEvents.push_back(event);
+    }
+}
+
+void Input::discardEvents() {
+    UpdateKeyStates();
+    keysPressedThisUpdate.clear();
+    keysReleasedThisUpdate.clear();
+    buttonsPressedThisUpdate.clear();
+    buttonsReleasedThisUpdate.clear();
+    frameEvents.clear();
+}
+
 bool Input::justPressed(SDL_Scancode key) {
-    return currentPressedKeys.find(key) != currentPressedKeys.end() &&
-        previousPressedKeys.find(key) == previousPressedKeys.end();
+    return keysPressedThisUpdate.find(key) != keysPressedThisUpdate.end();
 }
 
 bool Input::justReleased(SDL_Scancode key) {
-    return previousPressedKeys.find(key) != previousPressedKeys.end() &&
-        currentPressedKeys.find(key) == currentPressedKeys.end();
+    return keysReleasedThisUpdate.find(key) != keysReleasedThisUpdate.end();
 }
 
 bool Input::pressed(SDL_Scancode key) {
     return currentPressedKeys.find(key) != currentPressedKeys.end();
 }
 
-void Input::UpdateControllerStates() {
+void Input::pollControllers(Uint32 timestamp) {
     #ifdef __SWITCH__
     padUpdate(&pad);
     HidAnalogStickState analog_stick_l = padGetStickPos(&pad, 0);
@@ -107,112 +184,46 @@ void Input::UpdateControllerStates() {
     controllerAxisState[SDL_CONTROLLER_AXIS_RIGHTX] = analog_stick_r.x;
     controllerAxisState[SDL_CONTROLLER_AXIS_RIGHTY] = analog_stick_r.y;
     
+    static const struct { u64 mask; Uint8 button; } buttonMap[] = {
+        { HidNpadButton_A, SDL_CONTROLLER_BUTTON_A },
+        { HidNpadButton_B, SDL_CONTROLLER_BUTTON_B },
+        { HidNpadButton_X, SDL_CONTROLLER_BUTTON_X },
+        { HidNpadButton_Y, SDL_CONTROLLER_BUTTON_Y },
+        { HidNpadButton_L, SDL_CONTROLLER_BUTTON_LEFTSHOULDER },
+        { HidNpadButton_R, SDL_CONTROLLER_BUTTON_RIGHTSHOULDER },
+        { HidNpadButton_Plus, SDL_CONTROLLER_BUTTON_START },
+        { HidNpadButton_Minus, SDL_CONTROLLER_BUTTON_BACK },
+        { HidNpadButton_Up, SDL_CONTROLLER_BUTTON_DPAD_UP },
+        { HidNpadButton_Down, SDL_CONTROLLER_BUTTON_DPAD_DOWN },
+        { HidNpadButton_Left, SDL_CONTROLLER_BUTTON_DPAD_LEFT },
+        { HidNpadButton_Right, SDL_CONTROLLER_BUTTON_DPAD_RIGHT },
+    };
+
+    // The pad is polled rather than evented, so turn changes into events here.
     u64 buttons = padGetButtons(&pad);
-    
-    previousControllerState = currentControllerState;
-    
-    currentControllerState[SDL_CONTROLLER_BUTTON_A] = (buttons & HidNpadButton_A) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_B] = (buttons & HidNpadButton_B) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_X] = (buttons & HidNpadButton_X) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_Y] = (buttons & HidNpadButton_Y) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_LEFTSHOULDER] = (buttons & HidNpadButton_L) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_RIGHTSHOULDER] = (buttons & HidNpadButton_R) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_START] = (buttons & HidNpadButton_Plus) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_BACK] = (buttons & HidNpadButton_Minus) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_DPAD_UP] = (buttons & HidNpadButton_Up) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_DPAD_DOWN] = (buttons & HidNpadButton_Down) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_DPAD_LEFT] = (buttons & HidNpadButton_Left) != 0;
-    currentControllerState[SDL_CONTROLLER_BUTTON_DPAD_RIGHT] = (buttons & HidNpadButton_Right) != 0;
+    for (const auto& entry : buttonMap) {
+        bool down = (buttons & entry.mask) != 0;
+        if (down == ((polledButtons & entry.mask) != 0)) continue;
+        pushEvent({ down ? InputEvent::Type::ButtonDown : InputEvent::Type::ButtonUp, entry.button, timestamp });
+    }
+    polledButtons = buttons;
     #else
+    // Buttons arrive as SDL_CONTROLLERBUTTON events through queueEvent.
+    (void)timestamp;
     if (sdlController) {
-        previousControllerState = currentControllerState;
-        
-        for (int i = 0; i < SDL_CONTROLLER_BUTTON_MAX; i++) {
-            currentControllerState[i] = SDL_GameControllerGetButton(sdlController, static_cast<SDL_GameControllerButton>(i));
-        }
-        
         for (int i = 0; i < SDL_CONTROLLER_AXIS_MAX; i++) {
-            controllerAxisState[static_cast<SDL_GameControllerAxis>(i)] = 
-                SDL_GameControllerGetAxis(sdlController, static_cast<SDL_GameControllerAxis>(i));
+            controllerAxisState[i] = SDL_GameControllerGetAxis(sdlController, static_cast<SDL_GameControllerAxis>(i));
         }
-    } else {
-        static bool logged = false;
-        if (!logged) {
-            Log::getInstance().warning("No controller connected or initialized");
-            logged = true;
-        }
-    }
-    #endif
-}
-
-void Input::handleJoyButtonEvent(const SDL_JoyButtonEvent& event) {
-    #ifdef __SWITCH__
-    Uint8 mappedButton = event.button;
-    switch (event.button) {
-        case 0:
-            mappedButton = SDL_CONTROLLER_BUTTON_A;
-            break;
-        case 1:
-            mappedButton = SDL_CONTROLLER_BUTTON_B;
-            break;
-        case 2:
-            mappedButton = SDL_CONTROLLER_BUTTON_X;
-            break;
-        case 3:
-            mappedButton = SDL_CONTROLLER_BUTTON_Y;
-            break;
-        case 4:
-            mappedButton = SDL_CONTROLLER_BUTTON_LEFTSHOULDER;
-            break;
-        case 5:
-            mappedButton = SDL_CONTROLLER_BUTTON_RIGHTSHOULDER;
-            break;
-        case 6:
-            mappedButton = SDL_CONTROLLER_BUTTON_START;
-            break;
-        case 7:
-            mappedButton = SDL_CONTROLLER_BUTTON_RIGHTSTICK;
-            break;
-        case 8:
-            mappedButton = SDL_CONTROLLER_BUTTON_BACK;
-            break;
-        case 9:
-            mappedButton = SDL_CONTROLLER_BUTTON_LEFTSTICK;
-            break;
-        case 10:
-            mappedButton = SDL_CONTROLLER_BUTTON_LEFTSTICK;
-            break;
-        case 11:
-            mappedButton = SDL_CONTROLLER_BUTTON_RIGHTSTICK;
-            break;
-        case 12:
-            mappedButton = SDL_CONTROLLER_BUTTON_DPAD_LEFT;
-            break;
-        case 13:
-            mappedButton = SDL_CONTROLLER_BUTTON_DPAD_UP;
-            break;
-        case 14:
-            mappedButton = SDL_CONTROLLER_BUTTON_DPAD_RIGHT;
-            break;
-        case 15:
-            mappedButton = SDL_CONTROLLER_BUTTON_DPAD_DOWN;
-            break;
-    }
-
-    if (event.state == SDL_PRESSED) {
-        currentControllerState[mappedButton] = true;
-    } else {
-        currentControllerState[mappedButton] = false;
     }
     #endif
 }
 
 bool Input::isControllerButtonJustPressed(Uint8 button) {
-    return currentControllerState[button] && !previousControllerState[button];
+    return buttonsPressedThisUpdate.find(button) != buttonsPressedThisUpdate.end();
 }
 
 bool Input::isControllerButtonJustReleased(Uint8 button) {
-    return !currentControllerState[button] && previousControllerState[button];
+    return buttonsReleasedThisUpdate.find(button) != buttonsReleasedThisUpdate.end();
 }
 
 bool Input::isControllerButtonPressed(Uint8 button) {
@@ -220,5 +231,6 @@ bool Input::isControllerButtonPressed(Uint8 button) {
 }
 
 Sint16 Input::getControllerAxis(SDL_GameControllerAxis axis) {
+    if (axis < 0 || axis >= SDL_CONTROLLER_AXIS_MAX) return 0;
     return controllerAxisState[axis];
 }
\ No newline at end of file
@@ -8,36 +8,74 @@
 #else
 #include "../core/SDLManager.h"
 #endif
+#include <atomic>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
+#include "../utils/SpscRing.h"
+
+struct InputEvent {
+    enum class Type : Uint8 { KeyDown, KeyUp, ButtonDown, ButtonUp };
+
+    Type type;
+    Uint16 code;        // SDL_Scancode for keys, SDL_GameControllerButton for buttons
+    Uint32 timestamp;   // Engine::getTicks() (ms) when the event was delivered
+};
 
 class Input {
 public:
+    // Called from Engine::handleEvents on the main thread; ignores non-input events.
+    // timestamp is the event's time on the engine clock, which headless runs keep
+    // virtual, so presses compare against the same clock as the song position.
+    static void queueEvent(const SDL_Event& event, Uint32 timestamp);
+    // Main thread, once per event pump: turns polled pad buttons into queued
+    // events and samples the sticks.
+    static void pollControllers(Uint32 timestamp);
+
+    // Consumes every queued event in order. Key and button state is rebuilt from
+    // the events, so a tap pressed and released between two updates still reports
+    // justPressed and justReleased.
     static void UpdateKeyStates();
+    // Events consumed by the last UpdateKeyStates, oldest first.
+    static const std::vector<InputEvent>& getEvents() { return frameEvents; }
+    // Applies queued events to the held state without reporting them, so input
+    // made during a state change doesn't leak into the next state.
+    static void discardEvents();
+
     static bool justPressed(SDL_Scancode key);
     static bool justReleased(SDL_Scancode key);
     static bool pressed(SDL_Scancode key);
     
     static void initController();
     static void closeController();
-    static void UpdateControllerStates();
     static bool isControllerButtonJustPressed(Uint8 button);
     static bool isControllerButtonJustReleased(Uint8 button);
     static bool isControllerButtonPressed(Uint8 button);
     static Sint16 getControllerAxis(SDL_GameControllerAxis axis);
-    static void handleJoyButtonEvent(const SDL_JoyButtonEvent& event);
 
 private:
+    static constexpr size_t EVENT_QUEUE_SIZE = 1024;
+    static SpscRing<InputEvent, EVENT_QUEUE_SIZE> eventQueue;
+    static std::vector<InputEvent> frameEvents;
+
     static std::unordered_set<SDL_Scancode> currentPressedKeys;
-    static std::unordered_set<SDL_Scancode> previousPressedKeys;
+    static std::unordered_set<SDL_Scancode> keysPressedThisUpdate;
+    static std::unordered_set<SDL_Scancode> keysReleasedThisUpdate;
     
     static std::unordered_map<Uint8, bool> currentControllerState;
-    static std::unordered_map<Uint8, bool> previousControllerState;
-    static std::unordered_map<SDL_GameControllerAxis, Sint16> controllerAxisState;
+    static std::unordered_set<Uint8> buttonsPressedThisUpdate;
+    static std::unordered_set<Uint8> buttonsReleasedThisUpdate;
+    // Written by pollControllers, read from the simulation.
+    static std::atomic<Sint16> controllerAxisState[SDL_CONTROLLER_AXIS_MAX];
     
     #ifdef __SWITCH__
     static PadState pad;
+    // Buttons held at the last poll; only touched by pollControllers.
+    static u64 polledButtons;
     #else
     static SDL_GameController* sdlController;
     #endif
+
+    static void pushEvent(const InputEvent& event);
+    static void applyEvent(const InputEvent& event);
 };
\ No newline at end of file
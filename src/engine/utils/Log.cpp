@@ -26,21 +26,25 @@ Log::~Log() {
 }
 
 void Log::info(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex);
     write("INFO", message);
     std::cout << "[" << getTimestamp() << "] [" << "INFO" << "] " << message << std::endl;
 }
 
 void Log::warning(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex);
     write("WARNING", message);
     std::cout << "[" << getTimestamp() << "] [" << "WARNING" << "] " << message << std::endl;
 }
 
 void Log::error(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex);
     write("ERROR", message);
     std::cout << "[" << getTimestamp() << "] [" << "ERROR" << "] " << message << std::endl;
 }
 
 void Log::debug(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex);
     write("DEBUG", message);
 }
 
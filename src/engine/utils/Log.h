@@ -5,6 +5,7 @@
 #include <iomanip>
 #include <sstream>
 #include <filesystem>
+#include <mutex>
 
 class Log {
 public:
@@ -28,4 +29,6 @@ private:
 
     std::ofstream logFile;
     std::string logPath;
+    // Jobs log from worker threads.
+    std::mutex mutex;
 }; 
\ No newline at end of file
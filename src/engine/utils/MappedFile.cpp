@@ -0,0 +1,99 @@
+#include "MappedFile.h"
+#include "Log.h"
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !defined(__SWITCH__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP 1
+#endif
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize)) {
+            length = static_cast<size_t>(fileSize.QuadPart);
+            opened = true;
+            // Empty files can't be mapped; they're simply open with no bytes.
+            if (length > 0) {
+                mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                bytes = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+                if (bytes) {
+                    mapped = true;
+                } else {
+                    if (mapping) CloseHandle(mapping);
+                    mapping = nullptr;
+                    opened = false;
+                }
+            }
+        }
+        CloseHandle(file);
+        if (opened) return true;
+    }
+#elif defined(MAPPED_FILE_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat info;
+        if (fstat(fd, &info) == 0) {
+            length = static_cast<size_t>(info.st_size);
+            opened = true;
+            if (length > 0) {
+                void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED) {
+                    opened = false;
+                } else {
+                    bytes = static_cast<const char*>(address);
+                    mapped = true;
+                }
+            }
+        }
+        ::close(fd);
+        if (opened) return true;
+    }
+#endif
+
+    // No mapping on this platform, or it failed: read the file instead.
+    length = 0;
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream.is_open()) {
+        Log::getInstance().error("Failed to open file: " + path);
+        return false;
+    }
+    buffer.resize(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0);
+    if (!stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+        Log::getInstance().error("Failed to read file: " + path);
+        buffer.clear();
+        return false;
+    }
+    bytes = buffer.data();
+    length = buffer.size();
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(bytes);
+        CloseHandle(mapping);
+        mapping = nullptr;
+#elif defined(MAPPED_FILE_MMAP)
+        munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+    buffer.clear();
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+    mapped = false;
+}
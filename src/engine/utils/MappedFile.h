@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only view of a whole file. Mapped into memory where the platform allows
+// (Windows, POSIX), so opening a large atlas costs no copy and pages are only
+// touched as they're read; elsewhere the file is read into a buffer once.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Closes any file already open. Logs and returns false on failure.
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(bytes, length); }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+    bool opened = false;
+    // True when bytes is a mapping rather than buffer.
+    bool mapped = false;
+#ifdef _WIN32
+    void* mapping = nullptr;
+#endif
+    // Fallback storage when the file couldn't be mapped.
+    std::vector<char> buffer;
+};
@@ -0,0 +1,72 @@
+#include "MemoryArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+MemoryArena::MemoryArena(size_t blockSize) : blockSize(blockSize) {}
+
+MemoryArena::~MemoryArena() {
+    reset();
+    while (blocks) {
+        Block* next = blocks->next;
+        std::free(blocks);
+        blocks = next;
+    }
+}
+
+MemoryArena::Block* MemoryArena::addBlock(size_t minimumSize) {
+    size_t size = std::max(blockSize, minimumSize);
+    Block* block = static_cast<Block*>(std::malloc(sizeof(Block) + size));
+    if (!block) throw std::bad_alloc();
+    block->next = blocks;
+    block->size = size;
+    block->used = 0;
+    blocks = block;
+    bytesReserved += size;
+    return block;
+}
+
+void* MemoryArena::allocate(size_t size, size_t alignment) {
+    Block* block = blocks;
+    if (block) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(block->data());
+        uintptr_t aligned = (base + block->used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t end = static_cast<size_t>(aligned - base) + size;
+        if (end <= block->size) {
+            bytesUsed += end - block->used;
+            highWater = std::max(highWater, bytesUsed);
+            block->used = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+
+    // Oversized requests get a block of their own; the padding covers alignment.
+    block = addBlock(size + alignment);
+    uintptr_t base = reinterpret_cast<uintptr_t>(block->data());
+    uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    block->used = static_cast<size_t>(aligned - base) + size;
+    bytesUsed += block->used;
+    highWater = std::max(highWater, bytesUsed);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void MemoryArena::reset() {
+    while (finalizers) {
+        Finalizer* finalizer = finalizers;
+        finalizers = finalizer->next;
+        finalizer->destroy(finalizer->object);
+    }
+
+    // Keep the oldest block so a state that is rebuilt doesn't go back to malloc.
+    while (blocks && blocks->next) {
+        Block* next = blocks->next;
+        bytesReserved -= blocks->size;
+        std::free(blocks);
+        blocks = next;
+    }
+    if (blocks) {
+        blocks->used = 0;
+    }
+    bytesUsed = 0;
+    objectCount = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Bump allocator for objects that all die together, e.g. everything a State
+// creates. Memory comes from large blocks and is never freed piecemeal; objects
+// with destructors are recorded and destroyed in reverse order by reset().
+// Not thread-safe: one thread at a time (preload() then create() is fine).
+class MemoryArena {
+public:
+    explicit MemoryArena(size_t blockSize = 64 * 1024);
+    ~MemoryArena();
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Objects made here must not be deleted; they live until reset().
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        objectCount++;
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        } else {
+            Finalizer* finalizer = static_cast<Finalizer*>(allocate(sizeof(Finalizer), alignof(Finalizer)));
+            T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            finalizer->destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+            finalizer->object = object;
+            finalizer->next = finalizers;
+            finalizers = finalizer;
+            return object;
+        }
+    }
+
+    // Destroys every object, newest first, and rewinds to the first block.
+    void reset();
+
+    size_t getBytesUsed() const { return bytesUsed; }
+    size_t getHighWater() const { return highWater; }
+    size_t getBytesReserved() const { return bytesReserved; }
+    size_t getObjectCount() const { return objectCount; }
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+        size_t used;
+        unsigned char* data() { return reinterpret_cast<unsigned char*>(this + 1); }
+    };
+
+    struct Finalizer {
+        void (*destroy)(void*);
+        void* object;
+        Finalizer* next;
+    };
+
+    size_t blockSize;
+    Block* blocks = nullptr;   // newest first; the last one is kept across reset()
+    Finalizer* finalizers = nullptr;
+
+    size_t bytesUsed = 0;
+    size_t highWater = 0;
+    size_t bytesReserved = 0;
+    size_t objectCount = 0;
+
+    Block* addBlock(size_t minimumSize);
+};
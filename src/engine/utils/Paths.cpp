@@ -111,7 +111,7 @@ std::string Paths::image(const std::string& key) {
 void Paths::clearUnusedMemory() {
     for (auto it = currentTrackedAssets.begin(); it != currentTrackedAssets.end();) {
         if (std::find(localTrackedAssets.begin(), localTrackedAssets.end(), it->first) == localTrackedAssets.end()) {
-            SDL_DestroyTexture(it->second);
+            Renderer::getInstance().destroyTexture(it->second);
             it = currentTrackedAssets.erase(it);
         } else {
             ++it;
@@ -133,7 +133,7 @@ void Paths::clearUnusedMemory() {
 
 void Paths::clearStoredMemory() {
     for (auto& pair : currentTrackedAssets) {
-        SDL_DestroyTexture(pair.second);
+        Renderer::getInstance().destroyTexture(pair.second);
     }
     currentTrackedAssets.clear();
     
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Fixed-size lock-free queue for exactly one producer thread and one consumer
+// thread. Capacity must be a power of two; one slot is never used so that full
+// and empty can be told apart.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and drops the item) when full.
+    bool push(const T& item) {
+        size_t head = writeIndex.load(std::memory_order_relaxed);
+        size_t next = (head + 1) & MASK;
+        if (next == readIndex.load(std::memory_order_acquire)) return false;
+        items[head] = item;
+        writeIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.
+    bool pop(T& item) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == writeIndex.load(std::memory_order_acquire)) return false;
+        item = items[tail];
+        readIndex.store((tail + 1) & MASK, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return readIndex.load(std::memory_order_acquire) == writeIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    T items[Capacity];
+    alignas(64) std::atomic<size_t> writeIndex{ 0 };
+    alignas(64) std::atomic<size_t> readIndex{ 0 };
+};
@@ -68,6 +68,7 @@ void FunkinState::updateCurStep() {
 }
 
 void FunkinState::stepHit() {
+    Conductor::advanceStepTimers(curStep);
     if (curStep % 4 == 0) {
         beatHit();
     }
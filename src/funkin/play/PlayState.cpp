@@ -3,6 +3,8 @@
 #include <algorithm>
 #include "components/Song.h"
 #include "components/Conductor.h"
+#include "../../engine/utils/Paths.h"
+#include "../../engine/graphics/VideoExporter.h"
 #include <fstream>
 #include <map>
 #ifdef __SWITCH__ 
@@ -16,13 +18,13 @@
 PlayState* PlayState::instance = nullptr;
 SwagSong PlayState::SONG;
 Sound* PlayState::inst = nullptr;
+bool PlayState::autoplay = false;
 
 PlayState::PlayState() {
     instance = this;
     inst = nullptr;
     vocals = nullptr;
-    Note::loadAssets();
-    scoreText = new Text();
+    scoreText = arena.make<Text>();
     scoreText->setFormat("assets/fonts/vcr.ttf", 32, 0xFFFFFFFF);
     
     int windowWidth = Engine::getInstance()->getWindowWidth();
@@ -38,46 +40,35 @@ PlayState::~PlayState() {
         delete vocals;
         vocals = nullptr;
     }
-    if (inst != nullptr) {
-        delete inst;
+    // A newer PlayState may already have published its own instrumental.
+    if (inst == instSound) {
         inst = nullptr;
     }
+    delete instSound;
+    instSound = nullptr;
     
-    if (currentStage) {
-        delete currentStage;
-        currentStage = nullptr;
-    }
-    
-    if (camGame) {
-        delete camGame;
-        camGame = nullptr;
-    }
-    
-    if (camHUD) {
-        delete camHUD;
-        camHUD = nullptr;
-    }
-    
-    for (auto arrow : strumLineNotes) {
-        delete arrow;
-    }
+    // Stage, cameras, strums, notes and the score text live in the state arena.
+    currentStage = nullptr;
+    camGame = nullptr;
+    camHUD = nullptr;
     strumLineNotes.clear();
-    
-    for (auto note : notes) {
-        delete note;
-    }
     notes.clear();
-    
-    delete scoreText;
+    unspawnNotes.clear();
+    sustains.clear();
+    scoreText = nullptr;
     Note::unloadAssets();
     destroy();
+
+    if (instance == this) {
+        instance = nullptr;
+    }
 }
 
-void PlayState::loadSongConfig() {
+std::string PlayState::readSongConfig() {
     std::ifstream configFile("assets/data/config.json");
     if (!configFile.is_open()) {
         Log::getInstance().error("Failed to open config.json");
-        return;
+        return "";
     }
 
     try {
@@ -89,22 +80,52 @@ void PlayState::loadSongConfig() {
             std::string songName = songConfig["songName"].get<std::string>();
             std::string difficulty = songConfig["difficulty"].get<std::string>();
             
-            std::string fullSongName = difficulty.empty() ? songName : songName + "-" + difficulty;
-            generateSong(fullSongName);
+            return difficulty.empty() ? songName : songName + "-" + difficulty;
         } else {
             Log::getInstance().error("No songConfig found in config.json");
         }
     } catch (const std::exception& ex) {
         Log::getInstance().error("Failed to parse song config: " + std::string(ex.what()));
     }
+    return "";
 }
 
-void PlayState::loadStage() {
-    if (currentStage) {
-        delete currentStage;
-        currentStage = nullptr;
+std::string PlayState::getSongFolder(const std::string& songName) {
+    std::string folder = songName;
+    if (folder.length() >= 5 && folder.substr(folder.length() - 5) == "-easy" ||
+        folder.length() >= 5 && folder.substr(folder.length() - 5) == "-hard") {
+        size_t dashPos = folder.rfind("-");
+        if (dashPos != std::string::npos) {
+            folder = folder.substr(0, dashPos);
+        }
+    }
+    return folder;
+}
+
+void PlayState::declareAssets(AssetManifest& manifest) {
+    manifest.images.push_back("assets/images/NOTE_assets.png");
+    manifest.texts.push_back("assets/images/NOTE_assets.xml");
+
+    songToLoad = readSongConfig();
+    if (songToLoad.empty()) return;
+
+    std::string songFolder = "assets/songs/" + getSongFolder(songToLoad);
+    manifest.sounds.push_back(songFolder + "/Inst" + soundExt);
+    if (Paths::exists(songFolder + "/Voices" + soundExt)) {
+        manifest.sounds.push_back(songFolder + "/Voices" + soundExt);
     }
+}
 
+void PlayState::preload() {
+    if (songToLoad.empty()) {
+        songToLoad = readSongConfig();
+    }
+    if (!songToLoad.empty()) {
+        generateSong(songToLoad);
+    }
+}
+
+void PlayState::loadStage() {
     std::string stageName = "stage";
     
     /*
@@ -114,11 +135,10 @@ void PlayState::loadStage() {
         */
     
     try {
-        currentStage = new Stage(stageName);
+        currentStage = arena.make<Stage>(stageName, arena);
         if (!currentStage->isStageLoaded()) {
             Log::getInstance().warning("Failed to load stage: " + stageName + ", using default stage");
-            delete currentStage;
-            currentStage = new Stage("stage");
+            currentStage = arena.make<Stage>("stage", arena);
         }
         
         Log::getInstance().info("Loaded stage: " + stageName);
@@ -128,7 +148,7 @@ void PlayState::loadStage() {
         }
     } catch (const std::exception& e) {
         Log::getInstance().error("Error loading stage: " + std::string(e.what()));
-        currentStage = new Stage("stage");
+        currentStage = arena.make<Stage>("stage", arena);
         if (camGame) {
             currentStage->setCamera(camGame);
         }
@@ -151,19 +171,31 @@ void PlayState::setupHUDCamera() {
 }
 
 void PlayState::create() {
-    Mix_HaltChannel(-1);
+    // preload() ran on a worker while the previous state was still live, so the
+    // shared statics are only swapped here, once that state has stopped.
+    if (songLoaded) {
+        SONG = std::move(loadedSong);
+        songLoaded = false;
+    }
+    inst = instSound;
+
+    Engine::getInstance()->getSoundManager().stopAllSounds();
     Engine::getInstance()->getSoundManager().stopMusic();
     Conductor::songPosition = 0;
+    Conductor::resetStepTimers();
+    if (SONG.validScore) {
+        Conductor::changeBPM(SONG.bpm);
+    }
     startingSong = true;
     startedCountdown = false;
     Engine* engine = Engine::getInstance();
-    camGame = new Camera();
-    camHUD = new Camera();
+    camGame = arena.make<Camera>();
+    camHUD = arena.make<Camera>();
     camHUD->setZoom(1.0f);
     
     setupHUDCamera();
     
-    loadSongConfig();
+    Note::loadAssets();
     loadStage();
     startCountdown();
     generateNotes();
@@ -172,10 +204,12 @@ void PlayState::create() {
     #elif defined(__MINGW32__)
     // nun
     #else
-    char buffer[256];
-    snprintf(buffer, sizeof(buffer), "In Game - %s", curSong.c_str());
-    Discord::GetInstance().SetState(buffer);
-    Discord::GetInstance().Update();
+    if (!engine->isHeadless()) {
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "In Game - %s", curSong.c_str());
+        Discord::GetInstance().SetState(buffer);
+        Discord::GetInstance().Update();
+    }
     #endif
 }
 
@@ -187,9 +221,12 @@ void PlayState::update(float deltaTime) {
     } 
     else {
         Input::UpdateKeyStates();
-        Input::UpdateControllerStates();
 
-        handleInput();
+        if (autoplay) {
+            handleAutoplay(deltaTime);
+        } else {
+            handleInput();
+        }
         handleOpponentNoteHit(deltaTime);
         updateArrowAnimations();
 
@@ -200,7 +237,7 @@ void PlayState::update(float deltaTime) {
         }
 
         if (!startingSong && musicStartTicks > 0) {
-            Conductor::songPosition = static_cast<float>(SDL_GetTicks() - musicStartTicks);
+            Conductor::songPosition = static_cast<float>(Engine::getInstance()->getTicks() - musicStartTicks);
         }
 
         while (!unspawnNotes.empty()) {
@@ -213,16 +250,23 @@ void PlayState::update(float deltaTime) {
             unspawnNotes.erase(unspawnNotes.begin());
         }
 
+        // Note::update only touches the note itself, so spread it across workers;
+        // judgement and removal below stay on this thread.
+        Engine::getInstance()->getJobSystem().parallelFor(0, notes.size(), NOTE_UPDATE_GRAIN, [this, deltaTime](size_t i) {
+            if (notes[i]) {
+                notes[i]->update(deltaTime);
+            }
+        });
+
         for (auto it = notes.begin(); it != notes.end();) {
             Note* note = *it;
             if (note) {
-                note->update(deltaTime);
-
                 if (note->mustPress && note->tooLate && !note->wasGoodHit) {
                     noteMiss(note->noteData);
                     note->kill = true;
                 }
 
+                // Notes come from the state arena; dropping them here is enough.
                 if (note->kill || note->strumTime < Conductor::songPosition - 5000) {
                     it = notes.erase(it);
                 } else {
@@ -233,6 +277,8 @@ void PlayState::update(float deltaTime) {
             }
         }
 
+        sustains.update(Conductor::songPosition, getHeldLanes());
+
         if (startingSong) {
             if (startedCountdown) {
                 Conductor::songPosition += deltaTime * 1000;
@@ -268,33 +314,60 @@ void PlayState::update(float deltaTime) {
     }
 }
 
+float PlayState::getSongPositionAt(Uint32 ticks) const {
+    Uint32 now = Engine::getInstance()->getTicks();
+    if (!startingSong && musicStartTicks > 0) {
+        return static_cast<float>(static_cast<Sint64>(ticks) - static_cast<Sint64>(musicStartTicks));
+    }
+    return Conductor::songPosition - static_cast<float>(static_cast<Sint64>(now) - static_cast<Sint64>(ticks));
+}
+
+int PlayState::getLaneForEvent(const InputEvent& event) const {
+    for (int i = 0; i < 4; i++) {
+        bool isKey = event.type == InputEvent::Type::KeyDown || event.type == InputEvent::Type::KeyUp;
+        if (isKey) {
+            SDL_Scancode key = static_cast<SDL_Scancode>(event.code);
+            if (key == arrowKeys[i].primary || key == arrowKeys[i].alternate) return i;
+        } else {
+            if (event.code == nxArrowKeys[i].primary || event.code == nxArrowKeys[i].alternate) return i;
+        }
+    }
+    return -1;
+}
+
 void PlayState::handleInput() {
-    for (size_t i = 0; i < 4; i++) {
-        size_t arrowIndex = i + 4;
-        if (arrowIndex < strumLineNotes.size() && strumLineNotes[arrowIndex]) {
-            if (isKeyJustPressed(static_cast<int>(i)) || isNXButtonJustPressed(static_cast<int>(i))) {
-                strumLineNotes[arrowIndex]->playAnimation("pressed");
-                
-                bool noteHit = false;
-                for (auto note : notes) {
-                    if (note && note->mustPress && !note->wasGoodHit && note->noteData == static_cast<int>(i) && note->canBeHit) {
-                        goodNoteHit(note);
-                        noteHit = true;
-                        break;
-                    }
-                }
-                
-                if (!noteHit) {
-                    if (GameConfig::getInstance()->isGhostTapping()) {
-                        // do nun lol
-                    } else {
-                        noteMiss(static_cast<int>(i));
-                    }
+    // Judge each press against the song position at the moment it happened,
+    // not when this update got around to it.
+    for (const InputEvent& event : Input::getEvents()) {
+        int lane = getLaneForEvent(event);
+        if (lane < 0) continue;
+
+        size_t arrowIndex = static_cast<size_t>(lane) + 4;
+        if (arrowIndex >= strumLineNotes.size() || !strumLineNotes[arrowIndex]) continue;
+
+        if (event.type == InputEvent::Type::KeyUp || event.type == InputEvent::Type::ButtonUp) {
+            strumLineNotes[arrowIndex]->playAnimation("static");
+            continue;
+        }
+
+        strumLineNotes[arrowIndex]->playAnimation("pressed");
+
+        float pressTime = getSongPositionAt(event.timestamp);
+        Note* target = nullptr;
+        for (auto note : notes) {
+            if (!note || !note->mustPress || note->wasGoodHit || note->noteData != lane) continue;
+            if (note->strumTime > pressTime - Conductor::safeZoneOffset &&
+                note->strumTime < pressTime + (Conductor::safeZoneOffset * 0.5f)) {
+                if (!target || note->strumTime < target->strumTime) {
+                    target = note;
                 }
             }
-            else if (isKeyJustReleased(static_cast<int>(i)) || isNXButtonJustReleased(static_cast<int>(i))) {
-                strumLineNotes[arrowIndex]->playAnimation("static");
-            }
+        }
+
+        if (target) {
+            goodNoteHit(target);
+        } else if (!GameConfig::getInstance()->isGhostTapping()) {
+            noteMiss(lane);
         }
     }
 }
@@ -311,59 +384,63 @@ void PlayState::updateArrowAnimations() {
     }
 }
 
+unsigned PlayState::getHeldLanes() const {
+    if (autoplay) return 0xF;
+    unsigned held = 0;
+    for (int i = 0; i < 4; i++) {
+        if (isKeyPressed(i) || isNXButtonPressed(i)) held |= 1u << i;
+    }
+    return held;
+}
+
 void PlayState::generateSong(std::string dataPath) {
     try {
         std::string songName = dataPath;
-        std::string folder = dataPath;
-        std::string baseSongName = dataPath;
+        std::string folder = getSongFolder(dataPath);
+        std::string baseSongName = folder;
         
-        if (folder.length() >= 5 && folder.substr(folder.length() - 5) == "-easy" ||
-            folder.length() >= 5 && folder.substr(folder.length() - 5) == "-hard") {
-            size_t dashPos = folder.rfind("-");
-            if (dashPos != std::string::npos) {
-                folder = folder.substr(0, dashPos);
-                baseSongName = folder;
-            }
-        }
-        
-        SONG = Song::loadFromJson(songName, folder);
-        if (!SONG.validScore) {
+        SwagSong song = Song::loadFromJson(songName, folder);
+        if (!song.validScore) {
             Log::getInstance().error("Failed to load song data");
             return;
         }
         
-        Conductor::changeBPM(SONG.bpm);
         curSong = songName;
 
         std::cout << "Generated song: " << curSong 
-                  << " BPM: " << SONG.bpm 
-                  << " Speed: " << SONG.speed << std::endl;
+                  << " BPM: " << song.bpm 
+                  << " Speed: " << song.speed << std::endl;
 
-        if (vocals != nullptr) {
-            delete vocals;
-            vocals = nullptr;
-        }
-        if (inst != nullptr) {
-            delete inst;
-            inst = nullptr;
-        }
+        loadedSong = std::move(song);
+        songLoaded = true;
 
-        if (SONG.needsVoices) {
+        delete vocals;
+        vocals = nullptr;
+        delete instSound;
+        instSound = nullptr;
+
+        // Mixer loads are serialized anyway, so the two OGGs are decoded in turn.
+        if (loadedSong.needsVoices) {
             std::string vocalsPath = "assets/songs/" + baseSongName + "/Voices" + soundExt;
             vocals = new Sound();
             if (!vocals->load(vocalsPath)) {
                 Log::getInstance().error("Failed to load vocals: " + vocalsPath);
-                delete vocals;
-                vocals = nullptr;
             }
         }
 
         std::string instPath = "assets/songs/" + baseSongName + "/Inst" + soundExt;
-        inst = new Sound();
-        if (!inst->load(instPath)) {
+        instSound = new Sound();
+        if (!instSound->load(instPath)) {
             Log::getInstance().error("Failed to load instrumentals: " + instPath);
-            delete inst;
-            inst = nullptr;
+        }
+
+        if (vocals && !vocals->isLoaded()) {
+            delete vocals;
+            vocals = nullptr;
+        }
+        if (instSound && !instSound->isLoaded()) {
+            delete instSound;
+            instSound = nullptr;
         }
         
     } catch (const std::exception& ex) {
@@ -374,13 +451,28 @@ void PlayState::generateSong(std::string dataPath) {
 
 void PlayState::startSong() {
     startingSong = false;
-    musicStartTicks = SDL_GetTicks();
+    Engine* engine = Engine::getInstance();
+    musicStartTicks = engine->getTicks();
     if (vocals != nullptr) {
         vocals->play();
     }
     if (inst != nullptr) {
         inst->play();
     }
+
+    if (VideoExporter* exporter = engine->getVideoExporter()) {
+        if (inst != nullptr) {
+            exporter->addAudioTrack(inst->getChunk());
+            // Without an explicit frame limit, record the whole song plus a second.
+            if (!engine->hasMaxFrames()) {
+                engine->setMaxFrames(engine->getFrameCount() +
+                    static_cast<Uint64>((inst->getDuration() + 1.0f) * engine->getFrameRate()));
+            }
+        }
+        if (vocals != nullptr) {
+            exporter->addAudioTrack(vocals->getChunk());
+        }
+    }
 }
 
 void PlayState::startCountdown() {
@@ -391,6 +483,8 @@ void PlayState::startCountdown() {
 }
 
 void PlayState::render() {
+    Renderer& renderer = Renderer::getInstance();
+    renderer.setLayer(RenderLayer::World);
     if (camGame) {
         camGame->begin();
     }
@@ -399,16 +493,26 @@ void PlayState::render() {
         currentStage->render();
     }
 
+    // Notes never need to overlap each other in order, so let the queue group
+    // them by texture. They sit above the stage and below the strums, and holds
+    // sit under the heads.
+    renderer.setLayer(RenderLayer::Foreground);
+    if (Note::skin) {
+        sustains.render(*Note::skin, Conductor::songPosition);
+    }
+    renderer.beginGroup();
     for (auto note : notes) {
         if (note && note->isVisible()) {
             note->render();
         }
     }
+    renderer.endGroup();
 
     if (camGame) {
         camGame->end();
     }
 
+    renderer.setLayer(RenderLayer::HUD);
     if (camHUD) {
         camHUD->begin();
     }
@@ -432,6 +536,7 @@ void PlayState::render() {
     }
 
     if (!_subStates.empty()) {
+        renderer.setLayer(RenderLayer::Overlay);
         _subStates.back()->render();
     }
 }
@@ -453,7 +558,7 @@ void PlayState::generateStaticArrows(int player) {
     float xOffset = startX - (totalWidth * 0.5f);
         
     for (int i = 0; i < 4; i++) {
-        AnimatedSprite* babyArrow = new AnimatedSprite();
+        AnimatedSprite* babyArrow = arena.make<AnimatedSprite>();
         
         babyArrow->loadFrames("assets/images/NOTE_assets.png", "assets/images/NOTE_assets.xml");
 
@@ -487,6 +592,7 @@ void PlayState::generateStaticArrows(int player) {
 void PlayState::generateNotes() {
     unspawnNotes.clear();
     notes.clear();
+    sustains.clear();
 
     Log::getInstance().info("Generating notes from " + std::to_string(SONG.notes.size()) + " sections");
 
@@ -516,20 +622,10 @@ void PlayState::generateNotes() {
                     noteType = noteType % 4;
                 }
 
-                Log::getInstance().info("Creating note in section " + std::to_string(currentSection) + 
-                                     ": time=" + std::to_string(strumTime) + 
-                                     ", type=" + std::to_string(noteType) + 
-                                     ", mustPress=" + std::to_string(mustPress));
-
-                bool sustainNote = noteData.size() > 3 && noteData[3] > 0;
-                float sustainLength = sustainNote ? noteData[3] : 0;
+                float sustainLength = noteData.size() > 3 && noteData[3] > 0 ? noteData[3] : 0;
 
-                Note* prevNote = nullptr;
-                if (sustainNote && !unspawnNotes.empty()) {
-                    prevNote = unspawnNotes.back();
-                }
-
-                Note* note = new Note(strumTime, noteType, prevNote, sustainNote);
+                // A held note is a normal head plus an entry in the sustain trail.
+                Note* note = arena.make<Note>(strumTime, noteType);
                 note->mustPress = mustPress;
                 note->sustainLength = sustainLength;
                 
@@ -544,6 +640,9 @@ void PlayState::generateNotes() {
                 float totalWidth = arrowSpacing * 3;
                 float xOffset = baseX - (totalWidth * 0.5f) + (noteType * arrowSpacing);
                 note->setPosition(xOffset, 0);
+                if (sustainLength > 0) {
+                    sustains.add(strumTime, sustainLength, noteType, mustPress, xOffset);
+                }
                 
                 if (camGame) {
                     note->setCamera(camGame);
@@ -591,6 +690,9 @@ void PlayState::updateScoreText() {
 void PlayState::goodNoteHit(Note* note) {
     if (!note->wasGoodHit) {
         note->wasGoodHit = true;
+        if (note->sustainLength > 0) {
+            sustains.press(note->noteData, note->strumTime, note->mustPress);
+        }
         
         if (note->noteData >= 0 && note->noteData < 4) {
             int arrowIndex = note->noteData + 4;
@@ -751,6 +853,24 @@ SDL_GameControllerButton PlayState::getButtonFromString(const std::string& butto
     return SDL_CONTROLLER_BUTTON_INVALID;
 }
 
+void PlayState::handleAutoplay(float deltaTime) {
+    for (auto note : notes) {
+        if (note && note->mustPress && !note->wasGoodHit && note->strumTime <= Conductor::songPosition) {
+            goodNoteHit(note);
+            autoplayConfirm[note->noteData & 3] = 0.15f;
+        }
+    }
+
+    for (int lane = 0; lane < 4; lane++) {
+        if (autoplayConfirm[lane] <= 0.0f) continue;
+        autoplayConfirm[lane] -= deltaTime;
+        size_t arrowIndex = static_cast<size_t>(lane) + 4;
+        if (autoplayConfirm[lane] <= 0.0f && arrowIndex < strumLineNotes.size() && strumLineNotes[arrowIndex]) {
+            strumLineNotes[arrowIndex]->playAnimation("static");
+        }
+    }
+}
+
 void PlayState::handleOpponentNoteHit(float deltaTime) {
     static float animationTimer = 0.0f;
     static bool isAnimating = false;
@@ -773,6 +893,9 @@ void PlayState::handleOpponentNoteHit(float deltaTime) {
                 
                 note->wasGoodHit = true;
                 note->kill = true;
+                if (note->sustainLength > 0) {
+                    sustains.press(note->noteData, note->strumTime, note->mustPress);
+                }
             }
         }
     }
@@ -9,6 +9,7 @@
 #include "../../engine/utils/Log.h"
 #include "components/Song.h"
 #include "notes/Note.h"
+#include "notes/SustainTrail.h"
 #include "components/GameConfig.h"
 #include "stage/Stage.h"
 #include "../FunkinState.h"
@@ -43,6 +44,8 @@ public:
     PlayState();
     ~PlayState();
 
+    void declareAssets(AssetManifest& manifest) override;
+    void preload() override;
     void create() override;
     void update(float deltaTime) override;
     void render() override;
@@ -60,6 +63,8 @@ public:
     static PlayState* instance;
     static SwagSong SONG;
     static Sound* inst;
+    // Player notes hit themselves on time (showcase capture, benchmarks).
+    static bool autoplay;
     bool startingSong = false;
     bool startedCountdown = false;
 
@@ -75,11 +80,17 @@ public:
 private:
     std::string curSong;
     Sound* vocals = nullptr;
+    // Filled by preload() and published to SONG and inst by create().
+    SwagSong loadedSong;
+    bool songLoaded = false;
+    Sound* instSound = nullptr;
     std::vector<AnimatedSprite*> strumLineNotes;
     std::vector<Note*> notes;
+    SustainTrail sustains;
     Stage* currentStage = nullptr;
     Camera* camGame = nullptr;
     Camera* camHUD = nullptr;
+    static constexpr size_t NOTE_UPDATE_GRAIN = 64;
     const float STRUM_X = 42.0f;
     const float STRUM_X_MIDDLESCROLL = -278.0f;
     const std::vector<std::string> NOTE_STYLES = {"arrow", "arrow", "arrow", "arrow"};
@@ -89,11 +100,16 @@ private:
     std::array<NXBinding, 4> nxArrowKeys;
 
     void loadKeybinds();
-    void loadSongConfig();
+    std::string songToLoad;
+    std::string readSongConfig();
+    static std::string getSongFolder(const std::string& songName);
     void loadStage();
     void updateCameraZoom();
     void setupHUDCamera();
     void handleOpponentNoteHit(float deltaTime);
+    void handleAutoplay(float deltaTime);
+    // Seconds each player strum keeps its confirm pose under autoplay.
+    std::array<float, 4> autoplayConfirm = {};
     SDL_Scancode getScancodeFromString(const std::string& keyName);
     SDL_GameControllerButton getButtonFromString(const std::string& buttonName);
 
@@ -102,33 +118,18 @@ private:
         return Input::pressed(binding.primary) || Input::pressed(binding.alternate);
     }
 
-    bool isKeyJustPressed(int keyIndex) const {
-        const auto& binding = arrowKeys[keyIndex];
-        return Input::justPressed(binding.primary) || Input::justPressed(binding.alternate);
-    }
-
-    bool isKeyJustReleased(int keyIndex) const {
-        const auto& binding = arrowKeys[keyIndex];
-        return Input::justReleased(binding.primary) || Input::justReleased(binding.alternate);
-    }
-
     bool isNXButtonPressed(int keyIndex) const {
         const auto& binding = nxArrowKeys[keyIndex];
         return Input::isControllerButtonPressed(binding.primary) || Input::isControllerButtonPressed(binding.alternate);
     }
 
-    bool isNXButtonJustPressed(int keyIndex) const {
-        const auto& binding = nxArrowKeys[keyIndex];
-        return Input::isControllerButtonJustPressed(binding.primary) || Input::isControllerButtonJustPressed(binding.alternate);
-    }
-
-    bool isNXButtonJustReleased(int keyIndex) const {
-        const auto& binding = nxArrowKeys[keyIndex];
-        return Input::isControllerButtonJustReleased(binding.primary) || Input::isControllerButtonJustReleased(binding.alternate);
-    }
-
+    // Song position (ms) at an engine tick timestamp, for judging queued input.
+    float getSongPositionAt(Uint32 ticks) const;
+    int getLaneForEvent(const InputEvent& event) const;
     void handleInput();
     void updateArrowAnimations();
+    // Bit n set while player lane n is held (always under autoplay).
+    unsigned getHeldLanes() const;
     Text* scoreText;
     void updateScoreText();
     float pauseCooldown = 0.0f;
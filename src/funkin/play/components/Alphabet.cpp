@@ -31,7 +31,7 @@ Alphabet::Alphabet(const std::string& text, int x, int y) : baseX(x), baseY(y) {
         AnimatedSprite* spr = new AnimatedSprite();
         spr->copyFramesFrom(*baseSpr);
         spr->copyAnimationsFrom(*baseSpr);
-        spr->setTexture(baseSpr->shareTexture());
+        spr->setTexture(baseSpr->shareTexture(), false);
         std::string animName;
         std::string frameName;
         if (std::isdigit(c)) {
@@ -60,6 +60,10 @@ Alphabet::Alphabet(const std::string& text, int x, int y) : baseX(x), baseY(y) {
 }
 
 Alphabet::~Alphabet() {
+    if (!handles.empty()) {
+        removeFromEngine();
+        return;
+    }
     for (auto* spr : letters) {
         delete spr;
     }
@@ -82,15 +86,19 @@ void Alphabet::screenCenter() {
 }
 
 void Alphabet::addToEngine() {
+    if (!handles.empty()) return;
     for (auto* spr : letters) {
-        if (spr) Engine::getInstance()->addAnimatedSprite(spr);
+        if (spr) handles.push_back(Engine::getInstance()->addAnimatedSprite(spr));
     }
 }
 
 void Alphabet::removeFromEngine() {
-    for (auto* spr : letters) {
-        if (spr) spr->setVisible(false);
+    // Handles left stale by a state switch are ignored; the engine already freed those letters.
+    for (auto handle : handles) {
+        Engine::getInstance()->removeAnimatedSprite(handle);
     }
+    handles.clear();
+    letters.clear();
 }
 
 void Alphabet::render() {
@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include "../../../engine/graphics/AnimatedSprite.h"
+#include "../../../engine/core/HandleRegistry.h"
 
 class Alphabet {
 public:
@@ -13,5 +14,7 @@ public:
     void render();
 private:
     std::vector<AnimatedSprite*> letters;
+    // Set while the engine owns the letters; empty means this object still owns them.
+    std::vector<ObjectHandle<AnimatedSprite>> handles;
     int baseX, baseY;
 };
@@ -13,6 +13,7 @@ float Conductor::safeZoneOffset = 0;
 int Conductor::safeFrames = 10;
 
 std::vector<BPMChangeEvent> Conductor::bpmChangeMap;
+TimerWheel Conductor::stepTimers;
 
 Conductor::Conductor() {
 }
@@ -59,3 +60,13 @@ void Conductor::recalculateStuff(float songMultiplier) {
     stepCrochet = crochet / 4.0f;
     safeZoneOffset = (safeFrames / 60.0f) * 1000.0f;
 }
+
+void Conductor::advanceStepTimers(int curStep) {
+    if (curStep > 0) {
+        stepTimers.advanceTo(static_cast<uint64_t>(curStep));
+    }
+}
+
+void Conductor::resetStepTimers() {
+    stepTimers.reset();
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
+#include <algorithm>
 #include "Song.h"
+#include "../../../engine/core/TimerWheel.h"
 
 struct BPMChangeEvent {
     int stepTime;
@@ -22,9 +24,27 @@ public:
 
     static std::vector<BPMChangeEvent> bpmChangeMap;
 
+    // Beat-synced callbacks, keyed by absolute step and fired as curStep passes them.
+    static TimerWheel stepTimers;
+
     Conductor();
     
     static void mapBPMChanges(const SwagSong& song);
     static void changeBPM(float newBpm, float songMultiplier = 1.0f);
     static void recalculateStuff(float songMultiplier = 1.0f);
+
+    template <typename F>
+    static TimerHandle onStep(int step, F&& callback) {
+        return stepTimers.scheduleAt(static_cast<uint64_t>(std::max(step, 0)), std::forward<F>(callback));
+    }
+
+    template <typename F>
+    static TimerHandle onBeat(int beat, F&& callback) {
+        return onStep(beat * 4, std::forward<F>(callback));
+    }
+
+    static bool cancelStepTimer(TimerHandle handle) { return stepTimers.cancel(handle); }
+    static void advanceStepTimers(int curStep);
+    // Call when a song (re)starts from step 0.
+    static void resetStepTimers();
 };
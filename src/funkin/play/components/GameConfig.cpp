@@ -33,6 +33,14 @@ void GameConfig::loadConfig() {
             downscroll = false;
             ghostTapping = false;
         }
+
+        if (config.contains("displayConfig")) {
+            auto& displayConfig = config["displayConfig"];
+            frameMode = displayConfig.value("frameMode", std::string("vsync"));
+            frameRate = displayConfig.value("frameRate", 60);
+            updateRate = displayConfig.value("updateRate", 240);
+            mipEvictionDelay = displayConfig.value("mipEvictionDelay", 3000);
+        }
     } catch (const std::exception& e) {
         Log::getInstance().error("Error parsing config.json: " + std::string(e.what()));
     }
@@ -9,6 +9,10 @@ private:
     nlohmann::json config;
     bool downscroll;
     bool ghostTapping;
+    std::string frameMode = "vsync";
+    int frameRate = 60;
+    int updateRate = 240;
+    int mipEvictionDelay = 3000;
 
     GameConfig();
     void loadConfig();
@@ -18,6 +22,14 @@ public:
     
     bool isDownscroll() const { return downscroll; }
     bool isGhostTapping() const { return ghostTapping; }
+    // "vsync", "unlocked" or "capped". frameRate is the cap for "capped", the
+    // cap when vsync can't be turned on or the display's refresh rate is
+    // unknown, and the length of a frame on the headless virtual clock.
+    const std::string& getFrameMode() const { return frameMode; }
+    int getFrameRate() const { return frameRate; }
+    int getUpdateRate() const { return updateRate; }
+    // Milliseconds an unused reduced-size texture is kept (MipChain).
+    int getMipEvictionDelay() const { return mipEvictionDelay; }
     
     void setDownscroll(bool value);
     void setGhostTapping(bool value);
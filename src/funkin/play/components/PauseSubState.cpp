@@ -34,7 +34,6 @@ void PauseSubState::create() {
 
 void PauseSubState::update(float deltaTime) {
     Input::UpdateKeyStates();
-    Input::UpdateControllerStates();
 
     if (Input::justPressed(SDL_SCANCODE_RETURN) || Input::isControllerButtonJustPressed(SDL_CONTROLLER_BUTTON_START)) {
         std::cout << "Start button pressed in PauseSubState, closing" << std::endl;
@@ -54,12 +53,9 @@ void PauseSubState::update(float deltaTime) {
 }
 
 void PauseSubState::render() {
-    SDL_SetRenderDrawBlendMode(SDLManager::getInstance().getRenderer(), SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(SDLManager::getInstance().getRenderer(), 0, 0, 0, 128);
     Engine* engine = Engine::getInstance();
     SDL_Rect overlay = {0, 0, engine->getWindowWidth(), engine->getWindowHeight()};
-    SDL_RenderFillRect(SDLManager::getInstance().getRenderer(), &overlay);
-    SDL_SetRenderDrawColor(SDLManager::getInstance().getRenderer(), 0, 0, 0, 0);
+    Renderer::getInstance().fillRect(overlay, 0, 0, 0, 128);
 
     pauseText->render();
 }
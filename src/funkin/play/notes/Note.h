@@ -1,10 +1,11 @@
 #pragma once
 
-#include "../../../engine/graphics/AnimatedSprite.h"
-#include <map>
-#include <string>
+#include "../../../engine/graphics/Sprite.h"
+#include "NoteSkin.h"
 
-class Note : public AnimatedSprite {
+// Notes are plentiful (one per chart entry), so they carry no texture, frame
+// table or animation state of their own, only a skin pointer and a frame index.
+class Note : public Sprite {
 public:
     // Note types in FNF order: Left, Down, Up, Right
     static constexpr int LEFT_NOTE = 0;
@@ -12,34 +13,46 @@ public:
     static constexpr int UP_NOTE = 2;
     static constexpr int RIGHT_NOTE = 3;
 
+    static constexpr float NOTE_SCALE = 0.7f;
     static const float STRUM_X;
     static const float swagWidth;
 
-    static bool assetsLoaded;
-    static SDL_Texture* noteTexture;
-    static AnimatedSprite* sharedInstance;
-    static std::map<std::string, AnimatedSprite::Animation> noteAnimations;
+    static NoteSkin* skin;
 
     static void loadAssets();
     static void unloadAssets();
     static float getTargetY();
+    // Top of a note due at strumTime, and how far notes scroll per millisecond.
+    static float getScrollY(float strumTime, float songPosition);
+    static float getPixelsPerMs();
 
-    Note(float strumTime, int noteData, Note* prevNote = nullptr, bool sustainNote = false);
+    Note(float strumTime, int noteData);
     ~Note();
 
     void update(float deltaTime) override;
+    void render() override;
+    void setPiece(NoteSkin::Piece piece);
+    void updateHitbox() override;
     void setupNote();
-    void setupSustainNote();
+    void setOffset(float x, float y) {
+        offsetX = x;
+        offsetY = y;
+    }
 
     float strumTime;
     int noteData;
+    // Length of the hold this note starts (ms); 0 for a plain tap.
     float sustainLength;
     bool mustPress;
-    bool isSustainNote;
     bool canBeHit;
     bool wasGoodHit;
     bool tooLate;
     float noteScore;
-    Note* prevNote;
     bool kill = false;
+
+private:
+    const NoteSkin* noteSkin = nullptr;
+    int frameIndex = 0;
+    float offsetX = 0;
+    float offsetY = 0;
 }; 
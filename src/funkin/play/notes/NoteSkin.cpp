@@ -0,0 +1,37 @@
+#include "NoteSkin.h"
+#include "../../../engine/utils/Log.h"
+
+NoteSkin::~NoteSkin() {
+    delete atlas;
+}
+
+bool NoteSkin::load(const std::string& imagePath, const std::string& xmlPath) {
+    delete atlas;
+    atlas = new AnimatedSprite();
+    atlas->loadFrames(imagePath, xmlPath);
+    if (!atlas->shareTexture()) {
+        Log::getInstance().error("Failed to load note skin texture: " + imagePath);
+        return false;
+    }
+
+    static const char* laneColors[LANE_COUNT] = {"purple", "blue", "green", "red"};
+    static const char* pieceSuffixes[PIECE_COUNT] = {"0000", " hold piece0000", " hold end0000"};
+
+    frames.assign(LANE_COUNT * PIECE_COUNT, AnimatedSprite::Frame{});
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        for (int piece = 0; piece < PIECE_COUNT; piece++) {
+            std::string name = std::string(laneColors[lane]) + pieceSuffixes[piece];
+            const AnimatedSprite::Frame* frame = atlas->findFrame(name);
+            if (!frame) {
+                Log::getInstance().warning("Note skin is missing frame: " + name);
+                continue;
+            }
+            frames[getFrameIndex(lane, static_cast<Piece>(piece))] = *frame;
+        }
+    }
+    records.clear();
+    for (const AnimatedSprite::Frame& frame : frames) {
+        records.push_back(AnimatedSprite::DrawRecord::bake(frame));
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../../../engine/graphics/AnimatedSprite.h"
+#include <string>
+#include <vector>
+
+// Texture and frame table shared by every Note. The Sparrow XML is parsed once
+// when the skin loads; notes keep only a pointer to the skin and a frame index.
+class NoteSkin {
+public:
+    enum Piece { SCROLL = 0, HOLD = 1, HOLD_END = 2, PIECE_COUNT = 3 };
+    static constexpr int LANE_COUNT = 4;
+
+    NoteSkin() = default;
+    ~NoteSkin();
+    NoteSkin(const NoteSkin&) = delete;
+    NoteSkin& operator=(const NoteSkin&) = delete;
+
+    bool load(const std::string& imagePath, const std::string& xmlPath);
+
+    SDL_Texture* getTexture() const { return atlas ? atlas->shareTexture() : nullptr; }
+
+    static int getFrameIndex(int lane, Piece piece) {
+        return (lane % LANE_COUNT) * PIECE_COUNT + piece;
+    }
+    const AnimatedSprite::Frame& getFrame(int index) const { return frames[index]; }
+    const AnimatedSprite::DrawRecord& getRecord(int index) const { return records[index]; }
+
+private:
+    // Owns the texture and parses the atlas; never drawn.
+    AnimatedSprite* atlas = nullptr;
+    std::vector<AnimatedSprite::Frame> frames;
+    std::vector<AnimatedSprite::DrawRecord> records;
+};
@@ -0,0 +1,121 @@
+#include "SustainTrail.h"
+#include "Note.h"
+#include "../components/GameConfig.h"
+#include "../../../engine/graphics/Camera.h"
+#include "../../../engine/graphics/Renderer.h"
+#include <algorithm>
+#include <cmath>
+
+void SustainTrail::clear() {
+    pending.clear();
+    active.clear();
+    nextSpawn = 0;
+    sorted = true;
+}
+
+void SustainTrail::add(float startTime, float length, int lane, bool mustPress, float x) {
+    pending.push_back({ startTime, length, x, static_cast<uint8_t>(lane % NoteSkin::LANE_COUNT), mustPress, State::Waiting });
+    sorted = false;
+}
+
+void SustainTrail::press(int lane, float startTime, bool mustPress) {
+    for (Hold& hold : active) {
+        if (hold.lane == lane && hold.startTime == startTime && hold.mustPress == mustPress && hold.state == State::Waiting) {
+            hold.state = State::Holding;
+            return;
+        }
+    }
+}
+
+void SustainTrail::update(float songPosition, unsigned heldLanes) {
+    if (!sorted) {
+        std::stable_sort(pending.begin() + nextSpawn, pending.end(),
+            [](const Hold& a, const Hold& b) { return a.startTime < b.startTime; });
+        sorted = true;
+    }
+    while (nextSpawn < pending.size() && pending[nextSpawn].startTime - songPosition <= SPAWN_AHEAD) {
+        active.push_back(pending[nextSpawn++]);
+    }
+    if (nextSpawn == pending.size() && !pending.empty()) {
+        pending.clear();
+        nextSpawn = 0;
+    }
+
+    for (Hold& hold : active) {
+        float end = hold.startTime + hold.length;
+        if (hold.state == State::Holding) {
+            if (songPosition >= end) {
+                hold.state = State::Finished;
+            } else if (hold.mustPress && !(heldLanes & (1u << hold.lane))) {
+                hold.state = State::Dropped;
+            }
+        } else if (songPosition > end + 5000) {
+            // Same window after which missed notes are dropped.
+            hold.state = State::Finished;
+        }
+    }
+    active.erase(std::remove_if(active.begin(), active.end(),
+        [](const Hold& hold) { return hold.state == State::Finished; }), active.end());
+}
+
+void SustainTrail::render(const NoteSkin& skin, float songPosition) const {
+    bool downscroll = GameConfig::getInstance()->isDownscroll();
+    float pixelsPerMs = Note::getPixelsPerMs();
+
+    for (const Hold& hold : active) {
+        const AnimatedSprite::Frame& head = skin.getFrame(NoteSkin::getFrameIndex(hold.lane, NoteSkin::SCROLL));
+        const AnimatedSprite::Frame& body = skin.getFrame(NoteSkin::getFrameIndex(hold.lane, NoteSkin::HOLD));
+        const AnimatedSprite::Frame& end = skin.getFrame(NoteSkin::getFrameIndex(hold.lane, NoteSkin::HOLD_END));
+
+        // Distances along the strip, from the head's centre towards the tail.
+        float length = hold.length * pixelsPerMs;
+        float from = 0.0f;
+        if (hold.state == State::Holding) {
+            from = std::clamp((songPosition - hold.startTime) * pixelsPerMs, 0.0f, length);
+        }
+        if (from >= length) continue;
+
+        float headCenter = Note::getScrollY(hold.startTime, songPosition) + head.height * Note::NOTE_SCALE * 0.5f;
+        float headWidth = head.width * Note::NOTE_SCALE;
+        float bodyX = hold.x + (headWidth - body.width * Note::NOTE_SCALE) * 0.5f;
+        float endX = hold.x + (headWidth - end.width * Note::NOTE_SCALE) * 0.5f;
+
+        SDL_FRect bounds = { std::min(bodyX, endX), downscroll ? headCenter - length : headCenter + from,
+                             std::max(body.width, end.width) * Note::NOTE_SCALE, length - from };
+        if (!Camera::isOnScreen(bounds)) {
+            Renderer::getInstance().countCulled();
+            continue;
+        }
+
+        float alpha = hold.state == State::Dropped ? 0.3f : 0.6f;
+        float capStart = length - end.height * Note::NOTE_SCALE;
+        float bodyEnd = std::max(capStart, 0.0f);
+        float tile = body.height * Note::NOTE_SCALE;
+        if (tile > 0.0f) {
+            // Tiles are anchored at the head, so clipping eats into them rather
+            // than sliding the texture along the strip.
+            for (int i = static_cast<int>(from / tile); i * tile < bodyEnd; i++) {
+                float pieceStart = i * tile;
+                drawPiece(skin, body, bodyX, headCenter, pieceStart, std::max(from, pieceStart),
+                          std::min(bodyEnd, pieceStart + tile), alpha, downscroll);
+            }
+        }
+        drawPiece(skin, end, endX, headCenter, capStart, std::max(from, bodyEnd), length, alpha, downscroll);
+    }
+}
+
+void SustainTrail::drawPiece(const NoteSkin& skin, const AnimatedSprite::Frame& frame, float x, float headCenter,
+                             float pieceStart, float from, float to, float alpha, bool downscroll) const {
+    if (to <= from) return;
+
+    // Only the rows of the piece between from and to, so cut pieces aren't squashed.
+    int top = std::clamp(static_cast<int>(std::lround((from - pieceStart) / Note::NOTE_SCALE)), 0, frame.height);
+    int bottom = std::clamp(static_cast<int>(std::lround((to - pieceStart) / Note::NOTE_SCALE)), 0, frame.height);
+    if (bottom <= top) return;
+
+    SDL_Rect source = { frame.x, frame.y + top, frame.width, bottom - top };
+    // Downscroll runs the strip upwards; flipping keeps the head-side rows nearest the head.
+    SDL_FRect dest = { x, downscroll ? headCenter - to : headCenter + from, frame.width * Note::NOTE_SCALE, to - from };
+    Renderer::getInstance().drawTexture(skin.getTexture(), &source, dest, alpha,
+                                        downscroll ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "NoteSkin.h"
+#include <cstdint>
+#include <vector>
+
+// Every hold in the chart as a few numbers instead of a chain of sprites. A
+// visible hold is drawn as one strip: the hold piece tiled from the head's
+// centre down to the hold end, all with the skin texture, so consecutive quads
+// merge into a single geometry call. While a hold is being held the strip is
+// clipped at the strum line, so it appears to be consumed by the strum.
+class SustainTrail {
+public:
+    enum class State : uint8_t { Waiting, Holding, Dropped, Finished };
+
+    struct Hold {
+        float startTime;
+        float length;
+        // Left edge of the head note; the strip is centred under it.
+        float x;
+        uint8_t lane;
+        bool mustPress;
+        State state;
+    };
+
+    // How far ahead of its start a hold starts being updated and drawn; the
+    // same window notes spawn in.
+    static constexpr float SPAWN_AHEAD = 1500.0f;
+
+    void clear();
+    // length is in milliseconds, as in the chart. Holds may be added in any order.
+    void add(float startTime, float length, int lane, bool mustPress, float x);
+    // The head note of the hold at startTime in lane was hit.
+    void press(int lane, float startTime, bool mustPress);
+    // heldLanes has bit n set while player lane n is held. Player holds drop
+    // when their lane is released early; the opponent's always run to the end.
+    void update(float songPosition, unsigned heldLanes);
+    void render(const NoteSkin& skin, float songPosition) const;
+
+private:
+    // Every hold not yet spawned, sorted by startTime from nextSpawn on.
+    std::vector<Hold> pending;
+    size_t nextSpawn = 0;
+    bool sorted = true;
+    // Spawned holds, dropped again once they are finished or long gone, so the
+    // per-frame cost follows what is on screen rather than the chart length.
+    std::vector<Hold> active;
+
+    void drawPiece(const NoteSkin& skin, const AnimatedSprite::Frame& frame, float x, float headCenter,
+                   float pieceStart, float from, float to, float alpha, bool downscroll) const;
+};
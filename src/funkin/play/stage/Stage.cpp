@@ -4,13 +4,38 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
-Stage::Stage(const std::string& stageName) 
-    : curStage(stageName), defaultCamZoom(0.9f), stageLoaded(false), stageCamera(nullptr) {
+namespace {
+    // A layer that needs more rebakes than this within BAKE_QUIET_FRAMES is
+    // animating; it is drawn sprite by sprite for DIRECT_FRAMES before retrying.
+    constexpr int MAX_REBAKES = 3;
+    constexpr int BAKE_QUIET_FRAMES = 60;
+    constexpr int DIRECT_FRAMES = 300;
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    uint64_t hashValue(uint64_t hash, const T& value) {
+        return hashBytes(hash, &value, sizeof(value));
+    }
+}
+
+Stage::Stage(const std::string& stageName, MemoryArena& arena)
+    : curStage(stageName), arena(arena), defaultCamZoom(0.9f), stageLoaded(false), stageCamera(nullptr) {
     loadStageScript(stageName);
 }
 
 Stage::~Stage() {
+    releaseLayers();
     sprites.clear();
     namedSprites.clear();
 }
@@ -80,7 +105,7 @@ void Stage::createSprite(const json& spriteData) {
         }
 
         std::string imagePath = "assets/" + spriteData["path"].get<std::string>();
-        auto sprite = std::make_unique<Sprite>(imagePath);
+        Sprite* sprite = arena.make<Sprite>(imagePath);
 
         if (spriteData.contains("x")) {
             sprite->setPosition(spriteData["x"].get<float>(), sprite->getY());
@@ -96,6 +121,10 @@ void Stage::createSprite(const json& spriteData) {
             sprite->setScale(scale, scale);
         }
 
+        if (spriteData.contains("scrollX") || spriteData.contains("scrollY")) {
+            sprite->setScrollFactor(spriteData.value("scrollX", 1.0f), spriteData.value("scrollY", 1.0f));
+        }
+
         if (spriteData.contains("alpha")) {
             sprite->setAlpha(spriteData["alpha"].get<float>());
         }
@@ -111,10 +140,10 @@ void Stage::createSprite(const json& spriteData) {
         std::string spriteName = "";
         if (spriteData.contains("name")) {
             spriteName = spriteData["name"].get<std::string>();
-            namedSprites[spriteName] = sprite.get();
+            namedSprites[spriteName] = sprite;
         }
 
-        sprites.push_back(std::move(sprite));
+        sprites.push_back(sprite);
 
     } catch (const json::exception& e) {
         Log::getInstance().error("Error creating sprite: " + std::string(e.what()));
@@ -138,13 +167,200 @@ void Stage::update(float deltaTime) {
 }
 
 void Stage::render() {
-    for (auto& sprite : sprites) {
-        if (sprite->isVisible()) {
-            sprite->render();
+    Renderer& renderer = Renderer::getInstance();
+    if (!stageCamera || !renderer.supportsRenderTargets()) {
+        renderDirect(0, sprites.size());
+        return;
+    }
+
+    if (layersDirty) {
+        rebuildLayers();
+    }
+
+    size_t next = 0;
+    for (auto& layer : bakedLayers) {
+        renderDirect(next, layer.first - next);
+        renderLayer(layer);
+        next = layer.first + layer.count;
+    }
+    renderDirect(next, sprites.size() - next);
+}
+
+void Stage::renderDirect(size_t first, size_t count) {
+    for (size_t i = first; i < first + count; i++) {
+        if (sprites[i]->isVisible()) {
+            sprites[i]->render();
         }
     }
 }
 
+void Stage::rebuildLayers() {
+    releaseLayers();
+    layersDirty = false;
+
+    auto sameLayer = [](const Sprite& a, const Sprite& b) {
+        return a.getCamera() == b.getCamera()
+            && a.scrollFactor.x == b.scrollFactor.x && a.scrollFactor.y == b.scrollFactor.y;
+    };
+
+    size_t first = 0;
+    while (first < sprites.size()) {
+        size_t end = first + 1;
+        while (end < sprites.size() && sameLayer(*sprites[first], *sprites[end])) {
+            end++;
+        }
+        // A single sprite gains nothing from an extra texture.
+        if (end - first > 1 && sprites[first]->getCamera()) {
+            BakedLayer layer;
+            layer.first = first;
+            layer.count = end - first;
+            bakedLayers.push_back(layer);
+        }
+        first = end;
+    }
+}
+
+void Stage::releaseLayers() {
+    for (auto& layer : bakedLayers) {
+        if (layer.texture) {
+            Renderer::getInstance().destroyTexture(layer.texture);
+        }
+    }
+    bakedLayers.clear();
+}
+
+uint64_t Stage::computeSignature(const BakedLayer& layer, SDL_FRect& bounds) const {
+    Camera* camera = sprites[layer.first]->getCamera();
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashValue(hash, camera->getZoom());
+    hash = hashValue(hash, Renderer::getInstance().getTargetsGeneration());
+
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    bool any = false;
+    for (size_t i = layer.first; i < layer.first + layer.count; i++) {
+        const Sprite& sprite = *sprites[i];
+        if (!sprite.isVisible() || !sprite.getTexture()) {
+            hash = hashValue(hash, i);
+            continue;
+        }
+        float rect[4] = { sprite.getX(), sprite.getY(),
+                          sprite.getWidth() * sprite.getScale().x, sprite.getHeight() * sprite.getScale().y };
+        float alpha = sprite.getAlpha();
+        SDL_Texture* texture = sprite.getTexture();
+        hash = hashBytes(hash, rect, sizeof(rect));
+        hash = hashValue(hash, alpha);
+        hash = hashValue(hash, texture);
+
+        if (!any) {
+            minX = rect[0]; minY = rect[1];
+            maxX = rect[0] + rect[2]; maxY = rect[1] + rect[3];
+            any = true;
+        } else {
+            minX = std::min(minX, rect[0]); minY = std::min(minY, rect[1]);
+            maxX = std::max(maxX, rect[0] + rect[2]); maxY = std::max(maxY, rect[1] + rect[3]);
+        }
+    }
+    bounds = { minX, minY, maxX - minX, maxY - minY };
+    return hash;
+}
+
+bool Stage::bakeLayer(BakedLayer& layer, const SDL_FRect& bounds) {
+    Renderer& renderer = Renderer::getInstance();
+    if (layer.texture) {
+        renderer.destroyTexture(layer.texture);
+        layer.texture = nullptr;
+    }
+
+    float zoom = sprites[layer.first]->getCamera()->getZoom();
+    int width = static_cast<int>(std::ceil(bounds.w * zoom));
+    int height = static_cast<int>(std::ceil(bounds.h * zoom));
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    struct Draw {
+        SDL_Texture* texture;
+        SDL_FRect dest;
+        Uint8 alpha;
+    };
+    std::vector<Draw> draws;
+    for (size_t i = layer.first; i < layer.first + layer.count; i++) {
+        const Sprite& sprite = *sprites[i];
+        if (!sprite.isVisible() || !sprite.getTexture()) continue;
+        SDL_FRect dest = { (sprite.getX() - bounds.x) * zoom, (sprite.getY() - bounds.y) * zoom,
+                           sprite.getWidth() * sprite.getScale().x * zoom,
+                           sprite.getHeight() * sprite.getScale().y * zoom };
+        draws.push_back({ sprite.getTexture(), dest,
+                          static_cast<Uint8>(std::clamp(sprite.getAlpha(), 0.0f, 1.0f) * 255.0f) });
+    }
+
+    // Premultiplied sources need the alpha applied to their colour as well.
+    bool premultiplied = renderer.usesPremultipliedTextures();
+    layer.texture = renderer.renderToTexture(width, height, [&draws, premultiplied](SDL_Renderer* sdl) {
+        for (const Draw& draw : draws) {
+            SDL_SetTextureBlendMode(draw.texture, premultiplied ? Renderer::getPremultipliedBlendMode()
+                                                                : Renderer::getPremultiplyingBlendMode());
+            SDL_SetTextureAlphaMod(draw.texture, draw.alpha);
+            if (premultiplied) {
+                SDL_SetTextureColorMod(draw.texture, draw.alpha, draw.alpha, draw.alpha);
+            }
+            SDL_RenderCopyF(sdl, draw.texture, nullptr, &draw.dest);
+            SDL_SetTextureAlphaMod(draw.texture, 255);
+            SDL_SetTextureColorMod(draw.texture, 255, 255, 255);
+            SDL_SetTextureBlendMode(draw.texture, SDL_BLENDMODE_BLEND);
+        }
+    });
+    return layer.texture != nullptr;
+}
+
+void Stage::renderLayer(BakedLayer& layer) {
+    if (layer.directFrames > 0) {
+        layer.directFrames--;
+        renderDirect(layer.first, layer.count);
+        return;
+    }
+
+    SDL_FRect bounds;
+    uint64_t signature = computeSignature(layer, bounds);
+    if (!layer.texture || signature != layer.signature) {
+        if (layer.framesSinceBake > BAKE_QUIET_FRAMES) {
+            layer.rebakes = 0;
+        }
+        if (++layer.rebakes > MAX_REBAKES) {
+            Renderer::getInstance().destroyTexture(layer.texture);
+            layer.texture = nullptr;
+            layer.rebakes = 0;
+            layer.directFrames = DIRECT_FRAMES;
+            renderDirect(layer.first, layer.count);
+            return;
+        }
+
+        layer.signature = signature;
+        layer.framesSinceBake = 0;
+        layer.bounds = bounds;
+        if (!bakeLayer(layer, bounds)) {
+            layer.directFrames = DIRECT_FRAMES;
+            renderDirect(layer.first, layer.count);
+            return;
+        }
+    } else {
+        layer.framesSinceBake++;
+    }
+
+    const Sprite& lead = *sprites[layer.first];
+    Camera* camera = lead.getCamera();
+    SDL_FRect dest = layer.bounds;
+    dest.x += camera->x * (1.0f - lead.scrollFactor.x);
+    dest.y += camera->y * (1.0f - lead.scrollFactor.y);
+    if (!camera->isInView(dest)) {
+        Renderer::getInstance().countCulled();
+        return;
+    }
+
+    Renderer::getInstance().drawTexture(layer.texture, nullptr, dest, 1.0f, SDL_FLIP_NONE,
+                                        Renderer::getPremultipliedBlendMode(), camera);
+}
+
 void Stage::addSprite(Sprite* sprite, const std::string& name) {
     if (sprite) {
         if (stageCamera) {
@@ -154,8 +370,8 @@ void Stage::addSprite(Sprite* sprite, const std::string& name) {
         if (!name.empty()) {
             namedSprites[name] = sprite;
         }
-        auto spriteCopy = std::make_unique<Sprite>(*sprite);
-        sprites.push_back(std::move(spriteCopy));
+        sprites.push_back(arena.make<Sprite>(*sprite));
+        layersDirty = true;
     }
 }
 
@@ -167,13 +383,9 @@ void Stage::removeSprite(Sprite* sprite) {
         }
     }
 
-    sprites.erase(
-        std::remove_if(sprites.begin(), sprites.end(),
-            [sprite](const std::unique_ptr<Sprite>& s) {
-                return s.get() == sprite;
-            }),
-        sprites.end()
-    );
+    // The arena still owns it; it is only no longer drawn.
+    sprites.erase(std::remove(sprites.begin(), sprites.end(), sprite), sprites.end());
+    layersDirty = true;
 }
 
 Sprite* Stage::getSprite(const std::string& name) {
@@ -186,6 +398,7 @@ Sprite* Stage::getSprite(const std::string& name) {
 
 void Stage::setCamera(Camera* camera) {
     stageCamera = camera;
+    layersDirty = true;
     
     for (auto& sprite : sprites) {
         sprite->setCamera(camera);
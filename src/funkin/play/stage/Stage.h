@@ -4,17 +4,45 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <cstdint>
 #include "../../../engine/graphics/Sprite.h"
 #include "../../../engine/graphics/Camera.h"
+#include "../../../engine/utils/MemoryArena.h"
 #include "../../backend/json.hpp"
 
 using json = nlohmann::json;
 
 class Stage {
 private:
+    // A run of consecutive sprites sharing a camera and scroll factor. Their
+    // relative placement never changes with scrolling, so they are drawn once into
+    // a texture at the camera zoom and the texture is drawn in their place.
+    struct BakedLayer {
+        size_t first = 0;
+        size_t count = 0;
+        SDL_Texture* texture = nullptr;
+        SDL_FRect bounds = { 0, 0, 0, 0 };  // world space, before the parallax offset
+        uint64_t signature = 0;
+        int rebakes = 0;            // rebakes since the last quiet period
+        int framesSinceBake = 0;
+        int directFrames = 0;       // > 0: changing too often, draw the sprites instead
+    };
+    std::vector<BakedLayer> bakedLayers;
+    bool layersDirty = true;
+
+    void rebuildLayers();
+    void releaseLayers();
+    void renderLayer(BakedLayer& layer);
+    void renderDirect(size_t first, size_t count);
+    uint64_t computeSignature(const BakedLayer& layer, SDL_FRect& bounds) const;
+    bool bakeLayer(BakedLayer& layer, const SDL_FRect& bounds);
+
     std::string curStage;
     json stageData;
-    std::vector<std::unique_ptr<Sprite>> sprites;
+    // Sprites are made in the owning state's arena, which frees them with the
+    // state; these lists only point at them.
+    MemoryArena& arena;
+    std::vector<Sprite*> sprites;
     std::map<std::string, Sprite*> namedSprites;
     float defaultCamZoom;
     bool stageLoaded;
@@ -25,7 +53,7 @@ private:
     void setupCamera(const json& cameraData);
 
 public:
-    Stage(const std::string& stageName);
+    Stage(const std::string& stageName, MemoryArena& arena);
     ~Stage();
 
     void update(float deltaTime);
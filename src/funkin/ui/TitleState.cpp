@@ -42,6 +42,8 @@ void TitleState::create() {
     enter->setPosition(100, Engine::getInstance()->getWindowHeight() * 0.8f);
     enter->setAlpha(0);
     Engine::getInstance()->addAnimatedSprite(enter);
+
+    scheduleIntroText();
 }
 
 void TitleState::update(float deltaTime) {
@@ -53,12 +55,12 @@ void TitleState::update(float deltaTime) {
 
     static Uint32 musicStartTicks = 0;
     static bool musicStarted = false;
-    if (Mix_PlayingMusic()) {
+    if (Engine::getInstance()->getSoundManager().isMusicPlaying()) {
         if (!musicStarted) {
-            musicStartTicks = SDL_GetTicks();
+            musicStartTicks = Engine::getInstance()->getTicks();
             musicStarted = true;
         }
-        Conductor::songPosition = static_cast<float>(SDL_GetTicks() - musicStartTicks);
+        Conductor::songPosition = static_cast<float>(Engine::getInstance()->getTicks() - musicStartTicks);
     } else {
         musicStarted = false;
     }
@@ -81,28 +83,25 @@ void TitleState::update(float deltaTime) {
         if (enter) enter->playAnim("ENTER PRESSED");
         if (confirm) confirm->play();
         f = true;
-        Engine::getInstance()->switchState(new MainMenuState());
+        Engine::getInstance()->transitionTo(new MainMenuState());
         Input::UpdateKeyStates();
     }
 }
 
 void TitleState::render() {
-    SDL_Renderer* renderer = SDLManager::getInstance().getRenderer();
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    Renderer& renderer = Renderer::getInstance();
 
     if (gf) gf->render();
     if (logo) logo->render();
     if (enter) enter->render();
     if (whiteAlpha > 0.0f) {
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, static_cast<Uint8>(whiteAlpha * 255));
         SDL_Rect rect = {0, 0, Engine::getInstance()->getWindowWidth(), Engine::getInstance()->getWindowHeight()};
-        SDL_RenderFillRect(renderer, &rect);
+        renderer.fillRect(rect, 255, 255, 255, static_cast<Uint8>(whiteAlpha * 255));
     }
 
     if (!skippedIntro) {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_Rect bgRect = {0, 0, Engine::getInstance()->getWindowWidth(), Engine::getInstance()->getWindowHeight()};
-        SDL_RenderFillRect(renderer, &bgRect);
+        renderer.fillRect(bgRect, 0, 0, 0, 255);
     }
     for (auto* alpha : alphabets) {
         if (alpha) alpha->render();
@@ -111,9 +110,7 @@ void TitleState::render() {
 
 void TitleState::destroy() {
     for (auto* alpha : alphabets) {
-        if (alpha) {
-            alpha->removeFromEngine();
-        }
+        delete alpha;
     }
     alphabets.clear();
     if (gf) { gf = nullptr; }
@@ -141,14 +138,16 @@ void TitleState::createMoreCoolText(const std::string& line) {
 
 void TitleState::removeText() {
     for (auto* alpha : alphabets) {
-        if (alpha) {
-            alpha->removeFromEngine();
-        }
+        delete alpha;
     }
     alphabets.clear();
 }
 
 void TitleState::skipIntro() {
+    for (TimerHandle handle : introTimers) {
+        Conductor::cancelStepTimer(handle);
+    }
+    introTimers.clear();
     skippedIntro = true;
     removeText();
     whiteAlpha = 1.0f;
@@ -157,48 +156,28 @@ void TitleState::skipIntro() {
     if (enter) enter->setAlpha(1.0f);
 }
 
-void TitleState::beatHit() {
-    if (skippedIntro) return;
-    switch (curBeat) {
-    case 1:
-        createCoolText({ "NINJAMUFFIN99", "PHANTOMARCADE", "KAWAISPRITE", "EVILSKER" });
-        break;
-    case 3:
-        createMoreCoolText("PRESENT");
-        break;
-    case 4:
-        removeText();
-        break;
-    case 5:
-        createCoolText({ "NOT IN ASSOCIATION", "WITH" });
-        break;
-    case 7:
-        createMoreCoolText("NEWGROUNDS");
-        break;
-    case 8:
-        removeText();
-        break;
-    case 9:
-        createCoolText({ "POWERED BY" });
-        break;
-    case 11:
+void TitleState::scheduleIntroText() {
+    Conductor::resetStepTimers();
+    introTimers.clear();
+
+    auto atBeat = [this](int beat, auto callback) {
+        introTimers.push_back(Conductor::onBeat(beat, std::move(callback)));
+    };
+
+    atBeat(1, [this] { createCoolText({ "NINJAMUFFIN99", "PHANTOMARCADE", "KAWAISPRITE", "EVILSKER" }); });
+    atBeat(3, [this] { createMoreCoolText("PRESENT"); });
+    atBeat(4, [this] { removeText(); });
+    atBeat(5, [this] { createCoolText({ "NOT IN ASSOCIATION", "WITH" }); });
+    atBeat(7, [this] { createMoreCoolText("NEWGROUNDS"); });
+    atBeat(8, [this] { removeText(); });
+    atBeat(9, [this] { createCoolText({ "POWERED BY" }); });
+    atBeat(11, [this] {
         removeText();
         createCoolText({ "HAMBURGER ENGINE" });
-        break;
-    case 12:
-        removeText();
-        break;
-    case 13:
-        createMoreCoolText("FRIDAY");
-        break;
-    case 14:
-        createMoreCoolText("NIGHT");
-        break;
-    case 15:
-        createMoreCoolText("FUNKIN");
-        break;
-    case 16:
-        skipIntro();
-        break;
-    }
-}
\ No newline at end of file
+    });
+    atBeat(12, [this] { removeText(); });
+    atBeat(13, [this] { createMoreCoolText("FRIDAY"); });
+    atBeat(14, [this] { createMoreCoolText("NIGHT"); });
+    atBeat(15, [this] { createMoreCoolText("FUNKIN"); });
+    atBeat(16, [this] { skipIntro(); });
+}
@@ -16,12 +16,13 @@ public:
     void render() override;
     void destroy() override;
 
-    void beatHit() override;
     void createCoolText(const std::vector<std::string>& lines);
     void createMoreCoolText(const std::string& line);
     void removeText();
     void skipIntro();
 private:
+    void scheduleIntroText();
+
     AnimatedSprite* logo = nullptr;
     AnimatedSprite* gf = nullptr;
     AnimatedSprite* enter = nullptr;
@@ -30,4 +31,5 @@ private:
     bool skippedIntro = false;
     bool f = false;
     std::vector<Alphabet*> alphabets;
+    std::vector<TimerHandle> introTimers;
 };
\ No newline at end of file
@@ -14,6 +14,14 @@ static AnimatedSprite* baseMenuAssets = nullptr;
 MainMenuState::MainMenuState() : bg(nullptr) {}
 MainMenuState::~MainMenuState() { destroy(); }
 
+void MainMenuState::declareAssets(AssetManifest& manifest) {
+    manifest.images.push_back(Paths::image("menuBG"));
+    if (!baseMenuAssets) {
+        manifest.images.push_back(Paths::image("FNF_main_menu_assets"));
+        manifest.texts.push_back(Paths::xml("images/FNF_main_menu_assets"));
+    }
+}
+
 void MainMenuState::create() {
     selected = 0;
     scroll = Engine::getInstance()->getSoundManager().loadSound(Paths::sound("scrollMenu"));
@@ -32,12 +40,13 @@ void MainMenuState::create() {
         AnimatedSprite* option = new AnimatedSprite();
         option->copyFramesFrom(*baseMenuAssets);
         option->copyAnimationsFrom(*baseMenuAssets);
-        option->setTexture(baseMenuAssets->shareTexture());
+        option->setTexture(baseMenuAssets->shareTexture(), false);
         option->addAnimation(optionAnims[i] + " basic", optionAnims[i] + " basic", 24, true);
         option->addAnimation(optionAnims[i] + " white", optionAnims[i] + " white", 24, true);
         std::string animName = optionAnims[i] + (i == selected ? " white" : " basic");
         option->playAnimation(animName);
         option->update(0);
+        Engine::getInstance()->addAnimatedSprite(option);
         menuOptions.push_back(option);
     }
     int totalHeight = static_cast<int>(menuOptions.size()) * lineHeight;
@@ -63,15 +72,15 @@ void MainMenuState::update(float deltaTime) {
     if (Input::justPressed(SDL_SCANCODE_DOWN) || Input::justPressed(SDL_SCANCODE_S)) {
         switchMenu(1);
     }
-    if (Input::justPressed(SDL_SCANCODE_RETURN)) {
+    if (Input::justPressed(SDL_SCANCODE_RETURN) && !Engine::getInstance()->isTransitioning()) {
         if (confirm) confirm->play();
         if (selected == 0) { // story mode
             Engine::getInstance()->getSoundManager().stopMusic();
-            Engine::getInstance()->switchState(new PlayState());
+            Engine::getInstance()->transitionTo(new PlayState());
         }
         if (selected == 1) { // freeplay
             Engine::getInstance()->getSoundManager().stopMusic();
-            Engine::getInstance()->switchState(new PlayState());
+            Engine::getInstance()->transitionTo(new PlayState());
         }
         if (selected == 2) { // donate
         }
@@ -97,9 +106,6 @@ void MainMenuState::render() {
 }
 
 void MainMenuState::destroy() {
-    for (auto* option : menuOptions) {
-        if (option) option = nullptr;
-    }
     menuOptions.clear();
     if (bg) { bg = nullptr; }
 }
@@ -9,6 +9,7 @@ class MainMenuState : public FunkinState {
 public:
     MainMenuState();
     ~MainMenuState();
+    void declareAssets(AssetManifest& manifest) override;
     void create() override;
     void update(float deltaTime) override;
     void render() override;
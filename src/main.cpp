@@ -2,46 +2,128 @@
 #include "../engine/core/Engine.h"
 #include "funkin/ui/TitleState.h"
 #include "../engine/input/Input.h"
+#include "../engine/graphics/VideoExporter.h"
+#include "../engine/graphics/AtlasCache.h"
+#include "../engine/graphics/MipChain.h"
 #elif defined(__SWITCH__)
 #include "../engine/core/Engine.h"
 #include "funkin/ui/TitleState.h"
 #include "../engine/input/Input.h"
+#include "../engine/graphics/VideoExporter.h"
+#include "../engine/graphics/AtlasCache.h"
+#include "../engine/graphics/MipChain.h"
 #include <switch.h>
 #else
 #include <core/Engine.h>
 #include "funkin/ui/TitleState.h"
 #include <input/Input.h>
+#include <graphics/VideoExporter.h>
+#include <graphics/AtlasCache.h>
+#include <graphics/MipChain.h>
 #include <utils/Discord.h>
 #endif
+#include "funkin/play/PlayState.h"
+#include "funkin/play/components/GameConfig.h"
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 
 int main(int argc, char** argv) {
+    // --headless          dummy video/audio drivers, software renderer, virtual clock
+    // --frames <n>        quit after n frames
+    // --play              start straight in PlayState instead of the title screen
+    // --threaded          simulate on a separate thread; the main thread only presents
+    // --export <path>     autoplay the chart headless and write every frame to path
+    //                     (.y4m stream, otherwise a PNG directory) plus path.wav
+    // --bake-atlases      write the binary cache for every atlas in assets/images, then exit
+    // --cache-atlases     also write the cache for atlases parsed while playing
+    bool headless = false;
+    bool threaded = false;
+    bool startInPlayState = false;
+    Uint64 maxFrames = 0;
+    const char* exportPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            maxFrames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--play") == 0) {
+            startInPlayState = true;
+        } else if (std::strcmp(argv[i], "--threaded") == 0) {
+            threaded = true;
+        } else if (std::strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            exportPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--bake-atlases") == 0) {
+            return AtlasCache::bakeDirectory("assets/images") > 0 ? 0 : 1;
+        } else if (std::strcmp(argv[i], "--cache-atlases") == 0) {
+            AtlasCache::setSaveOnMiss(true);
+        }
+    }
+
+    if (exportPath) {
+        // One simulated frame per presented frame, on the virtual clock.
+        headless = true;
+        threaded = false;
+        startInPlayState = true;
+        PlayState::autoplay = true;
+    }
+
     #ifdef __MINGW32__
     // nun
     #elif defined(__SWITCH__)
     // nun
     #else
-    Discord::GetInstance().Initialize("1347011960088035368");    
-    Discord::GetInstance().SetState("hamburger engine");
-    Discord::GetInstance().SetDetails("Playing: Friday Night Funkin' HE by maybekoi");
-    Discord::GetInstance().SetLargeImage("hamburger");
-    Discord::GetInstance().SetLargeImageText("hamburger engine by maybekoi");
-    Discord::GetInstance().SetSmallImage("miku");
-    Discord::GetInstance().SetSmallImageText("HOLY SHIT IS THAT HATSUNE MIKU!?");    
-    Discord::GetInstance().Update();
+    if (!headless) {
+        Discord::GetInstance().Initialize("1347011960088035368");    
+        Discord::GetInstance().SetState("hamburger engine");
+        Discord::GetInstance().SetDetails("Playing: Friday Night Funkin' HE by maybekoi");
+        Discord::GetInstance().SetLargeImage("hamburger");
+        Discord::GetInstance().SetLargeImageText("hamburger engine by maybekoi");
+        Discord::GetInstance().SetSmallImage("miku");
+        Discord::GetInstance().SetSmallImageText("HOLY SHIT IS THAT HATSUNE MIKU!?");    
+        Discord::GetInstance().Update();
+    }
     #endif
     
     int width = 1280;
     int height = 720;
-    int fps = 60;
+    GameConfig* config = GameConfig::getInstance();
+    int fps = config->getFrameRate();
+    int updateRate = config->getUpdateRate();
     bool debug = true;
-    Engine engine(width, height, "Friday Night Funkin' HE", fps);
-    engine.debugMode = debug;
-    TitleState* initialState = new TitleState();
-    engine.pushState(initialState);
+    Engine engine(width, height, "Friday Night Funkin' HE", fps, headless);
+    engine.setFixedTimestep(updateRate);
+
+    FramePacing pacing = FramePacing::VSync;
+    if (config->getFrameMode() == "unlocked") {
+        pacing = FramePacing::Unlocked;
+    } else if (config->getFrameMode() == "capped") {
+        pacing = FramePacing::Capped;
+    }
+    engine.setMaxFrames(maxFrames);
+    engine.setThreadedRendering(threaded);
+    engine.setFramePacing(pacing);
+    MipChain::setEvictionDelay(static_cast<Uint32>(std::max(config->getMipEvictionDelay(), 0)));
+    engine.debugMode = debug && !exportPath;
+
+    VideoExporter exporter;
+    if (exportPath) {
+        if (!exporter.open(exportPath, width, height, fps)) {
+            return 1;
+        }
+        engine.setVideoExporter(&exporter);
+    }
+    if (startInPlayState) {
+        engine.pushState(new PlayState());
+    } else {
+        engine.pushState(new TitleState());
+    }
     
     #ifdef __SWITCH__
     while (appletMainLoop()) {
-        Input::UpdateControllerStates();
+        // The engine isn't running here, so poll and apply on this thread.
+        Input::pollControllers(SDL_GetTicks());
+        Input::UpdateKeyStates();
         if (Input::isControllerButtonPressed(SDL_CONTROLLER_BUTTON_BACK) || 
             Input::isControllerButtonPressed(SDL_CONTROLLER_BUTTON_START)) {
             engine.quit();
@@ -52,13 +134,20 @@ int main(int argc, char** argv) {
     #else
     engine.run();
     #endif
+
+    if (exportPath) {
+        engine.setVideoExporter(nullptr);
+        exporter.close();
+    }
     
     #ifdef __MINGW32__
     // nun
     #elif defined(__SWITCH__)
     // nun
     #else
-    Discord::GetInstance().Shutdown();
+    if (!headless) {
+        Discord::GetInstance().Shutdown();
+    }
     #endif
     return 0;
 }